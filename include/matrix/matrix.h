@@ -0,0 +1,581 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <matrix/matrix_kernels.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// dense matrix over a ring T (Residue, Galois2N...) in one row-major
+// array; Residue and Galois2N with n <= 64 are kept as raw words with
+// the modulo or field they share, run on the blocked kernels and become
+// elements only in the accessors; other types and mixed contexts keep
+// the elements and use element operations
+template < typename T >
+class Matrix
+{
+public:
+     Matrix( size_t rows = 0, size_t cols = 0, const T& value = T{} );
+     Matrix( size_t rows, size_t cols, std::vector< T > elems );    // row-major
+     static Matrix identity( size_t size, const T& one );
+
+     size_t rows() const;
+     size_t cols() const;
+     T operator() ( size_t i, size_t j ) const;
+     void set( size_t i, size_t j, const T& value );
+     std::vector< T > elems() const;     // row-major
+
+     Matrix& operator+= ( const Matrix& other );
+     Matrix& operator-= ( const Matrix& other );
+     Matrix& operator*= ( const Matrix& other );
+     bool operator== ( const Matrix& other ) const;
+     bool operator!= ( const Matrix& other ) const;
+
+     // reduced row echelon form in place, returns the pivot columns
+     std::vector< size_t > eliminate();
+     size_t rank() const;
+     Matrix inv() const;
+     // a solution x of *this * x = b, free variables are zero
+     std::vector< T > solve( const std::vector< T >& b ) const;
+
+private:
+     using Kernel = MatrixKernel< T >;
+     using context_type = typename Kernel::context_type;
+
+     size_t rows_;
+     size_t cols_;
+     bool packed_ = false;          // values are in words_, elems_ is empty
+     context_type ctx_{};           // empty while all the words are zero
+     std::vector< uint64_t > words_;
+     std::vector< T > elems_;
+
+     void check_same_size( const Matrix& other ) const;
+     T one() const;
+     T elem( size_t index ) const;
+     // packs elems when they share a context, keeps them otherwise
+     void assign( std::vector< T > elems );
+     void unpack();
+     bool shared_context( const Matrix& other, context_type& ctx ) const;
+     static bool fits( context_type& ctx, const T& value );
+};
+
+
+template < typename T >
+Matrix< T > operator+ ( Matrix< T > a, const Matrix< T >& b );
+
+template < typename T >
+Matrix< T > operator- ( Matrix< T > a, const Matrix< T >& b );
+
+template < typename T >
+Matrix< T > operator* ( Matrix< T > a, const Matrix< T >& b );
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+template < typename T >
+Matrix< T >::Matrix( size_t rows, size_t cols, const T& value ):
+     rows_{ rows }, cols_{ cols }
+{
+     if constexpr ( Kernel::enabled )
+     {
+          if ( fits( ctx_, value ) )
+          {
+               packed_ = true;
+               words_.assign( rows * cols, Kernel::value( value ) );
+               return;
+          }
+     }
+     elems_.assign( rows * cols, value );
+}
+
+
+template < typename T >
+Matrix< T >::Matrix( size_t rows, size_t cols, std::vector< T > elems ):
+     rows_{ rows }, cols_{ cols }
+{
+     if ( elems.size() != rows_ * cols_ )
+     {
+          throw std::runtime_error{ "matrix size does not match elements" };
+     }
+     assign( std::move( elems ) );
+}
+
+
+template < typename T >
+Matrix< T > Matrix< T >::identity( size_t size, const T& one )
+{
+     Matrix< T > result{ size, size, one - one };
+     for ( size_t i = 0; i < size; i++ )
+     {
+          result.set( i, i, one );
+     }
+     return result;
+}
+
+
+template < typename T >
+size_t Matrix< T >::rows() const
+{
+     return rows_;
+}
+
+
+template < typename T >
+size_t Matrix< T >::cols() const
+{
+     return cols_;
+}
+
+
+template < typename T >
+T Matrix< T >::operator() ( size_t i, size_t j ) const
+{
+     return elem( i * cols_ + j );
+}
+
+
+// a value outside the common context moves the matrix to elements
+template < typename T >
+void Matrix< T >::set( size_t i, size_t j, const T& value )
+{
+     if constexpr ( Kernel::enabled )
+     {
+          if ( packed_ && fits( ctx_, value ) )
+          {
+               words_[ i * cols_ + j ] = Kernel::value( value );
+               return;
+          }
+          unpack();
+     }
+     elems_[ i * cols_ + j ] = value;
+}
+
+
+template < typename T >
+std::vector< T > Matrix< T >::elems() const
+{
+     if constexpr ( Kernel::enabled )
+     {
+          if ( packed_ )
+          {
+               std::vector< T > result;
+               result.reserve( words_.size() );
+               for ( size_t i = 0; i < words_.size(); i++ )
+               {
+                    result.push_back( elem( i ) );
+               }
+               return result;
+          }
+     }
+     return elems_;
+}
+
+
+template < typename T >
+Matrix< T >& Matrix< T >::operator+= ( const Matrix< T >& other )
+{
+     check_same_size( other );
+     if constexpr ( Kernel::enabled )
+     {
+          context_type ctx{};
+          if ( shared_context( other, ctx ) )
+          {
+               for ( size_t i = 0; i < words_.size(); i++ )
+               {
+                    words_[ i ] = Kernel::add( ctx, words_[ i ], other.words_[ i ] );
+               }
+               ctx_ = ctx;
+               return *this;
+          }
+     }
+     unpack();
+     for ( size_t i = 0; i < elems_.size(); i++ )
+     {
+          elems_[ i ] += other.elem( i );
+     }
+     assign( std::move( elems_ ) );
+     return *this;
+}
+
+
+template < typename T >
+Matrix< T >& Matrix< T >::operator-= ( const Matrix< T >& other )
+{
+     check_same_size( other );
+     if constexpr ( Kernel::enabled )
+     {
+          context_type ctx{};
+          if ( shared_context( other, ctx ) )
+          {
+               for ( size_t i = 0; i < words_.size(); i++ )
+               {
+                    words_[ i ] = Kernel::sub( ctx, words_[ i ], other.words_[ i ] );
+               }
+               ctx_ = ctx;
+               return *this;
+          }
+     }
+     unpack();
+     for ( size_t i = 0; i < elems_.size(); i++ )
+     {
+          elems_[ i ] -= other.elem( i );
+     }
+     assign( std::move( elems_ ) );
+     return *this;
+}
+
+
+template < typename T >
+Matrix< T >& Matrix< T >::operator*= ( const Matrix< T >& other )
+{
+     if ( cols_ != other.rows_ )
+     {
+          throw std::runtime_error{ "matrix sizes do not match" };
+     }
+     size_t n = rows_, m = cols_, p = other.cols_;
+     if constexpr ( Kernel::enabled )
+     {
+          context_type ctx{};
+          if ( shared_context( other, ctx ) )
+          {
+               std::vector< uint64_t > c( n * p );
+               if ( Kernel::ring( ctx ) )
+               {
+                    Kernel::mul( ctx, c.data(), words_.data(), other.words_.data(), n, m, p );
+               }
+               ctx_ = ctx;
+               cols_ = p;
+               words_ = std::move( c );
+               return *this;
+          }
+     }
+     unpack();
+     std::vector< T > rhs = other.elems();
+     // i-k-j order walks rows of other and of the result
+     std::vector< T > result( n * p );
+     for ( size_t i = 0; i < n; i++ )
+     {
+          for ( size_t k = 0; k < m; k++ )
+          {
+               const T& a_ik = elems_[ i * m + k ];
+               if ( !a_ik )
+               {
+                    continue;
+               }
+               for ( size_t j = 0; j < p; j++ )
+               {
+                    result[ i * p + j ] += a_ik * rhs[ k * p + j ];
+               }
+          }
+     }
+     cols_ = p;
+     assign( std::move( result ) );
+     return *this;
+}
+
+
+template < typename T >
+bool Matrix< T >::operator== ( const Matrix< T >& other ) const
+{
+     if ( rows_ != other.rows_ || cols_ != other.cols_ )
+     {
+          return false;
+     }
+     if constexpr ( Kernel::enabled )
+     {
+          context_type ctx{};
+          if ( shared_context( other, ctx ) )
+          {
+               return words_ == other.words_;
+          }
+     }
+     for ( size_t i = 0; i < rows_ * cols_; i++ )
+     {
+          if ( elem( i ) != other.elem( i ) )
+          {
+               return false;
+          }
+     }
+     return true;
+}
+
+
+template < typename T >
+bool Matrix< T >::operator!= ( const Matrix< T >& other ) const
+{
+     return !( *this == other );
+}
+
+
+// Gauss-Jordan: each pivot row is scaled to a leading one and cleared
+// from all the other rows
+template < typename T >
+std::vector< size_t > Matrix< T >::eliminate()
+{
+     if constexpr ( Kernel::enabled )
+     {
+          if ( packed_ && !Kernel::ring( ctx_ ) )
+          {
+               return {};     // all zero
+          }
+          if ( packed_ && Kernel::field( ctx_ ) )
+          {
+               return Kernel::eliminate( ctx_, words_.data(), rows_, cols_ );
+          }
+     }
+     unpack();
+     std::vector< size_t > pivots;
+     for ( size_t col = 0, r = 0; col < cols_ && r < rows_; col++ )
+     {
+          size_t s = r;
+          while ( s < rows_ && !elems_[ s * cols_ + col ] )
+          {
+               s++;
+          }
+          if ( s == rows_ )
+          {
+               continue;
+          }
+          T* pivot = elems_.data() + r * cols_;
+          if ( s != r )
+          {
+               std::swap_ranges( pivot + col, pivot + cols_, elems_.data() + s * cols_ + col );
+          }
+          T scale = pivot[ col ].inv();
+          for ( size_t j = col; j < cols_; j++ )
+          {
+               pivot[ j ] *= scale;
+          }
+          for ( size_t i = 0; i < rows_; i++ )
+          {
+               T* row = elems_.data() + i * cols_;
+               if ( i == r || !row[ col ] )
+               {
+                    continue;
+               }
+               T factor = row[ col ];
+               for ( size_t j = col; j < cols_; j++ )
+               {
+                    row[ j ] -= factor * pivot[ j ];
+               }
+          }
+          pivots.push_back( col );
+          r++;
+     }
+     assign( std::move( elems_ ) );
+     return pivots;
+}
+
+
+template < typename T >
+size_t Matrix< T >::rank() const
+{
+     return Matrix< T >{ *this }.eliminate().size();
+}
+
+
+// [ A | I ] reduced to [ I | A^-1 ]
+template < typename T >
+Matrix< T > Matrix< T >::inv() const
+{
+     if ( rows_ != cols_ )
+     {
+          throw std::runtime_error{ "matrix is not square" };
+     }
+     size_t n = rows_;
+     T unit = one();
+     Matrix< T > augmented{ n, 2 * n, unit - unit };
+     for ( size_t i = 0; i < n; i++ )
+     {
+          for ( size_t j = 0; j < n; j++ )
+          {
+               augmented.set( i, j, ( *this )( i, j ) );
+          }
+          augmented.set( i, n + i, unit );
+     }
+     auto pivots = augmented.eliminate();
+     if ( pivots.size() != n || ( n && pivots.back() != n - 1 ) )
+     {
+          throw std::runtime_error{ "matrix is singular" };
+     }
+     Matrix< T > result{ n, n, unit - unit };
+     for ( size_t i = 0; i < n; i++ )
+     {
+          for ( size_t j = 0; j < n; j++ )
+          {
+               result.set( i, j, augmented( i, n + j ) );
+          }
+     }
+     return result;
+}
+
+
+// [ A | b ] reduced, a pivot in the last column means no solution
+template < typename T >
+std::vector< T > Matrix< T >::solve( const std::vector< T >& b ) const
+{
+     if ( b.size() != rows_ )
+     {
+          throw std::runtime_error{ "matrix sizes do not match" };
+     }
+     Matrix< T > augmented{ rows_, cols_ + 1 };
+     for ( size_t i = 0; i < rows_; i++ )
+     {
+          for ( size_t j = 0; j < cols_; j++ )
+          {
+               augmented.set( i, j, ( *this )( i, j ) );
+          }
+          augmented.set( i, cols_, b[ i ] );
+     }
+     auto pivots = augmented.eliminate();
+     if ( !pivots.empty() && pivots.back() == cols_ )
+     {
+          throw std::runtime_error{ "system has no solution" };
+     }
+     std::vector< T > x( cols_ );
+     for ( size_t r = 0; r < pivots.size(); r++ )
+     {
+          x[ pivots[ r ] ] = augmented( r, cols_ );
+     }
+     return x;
+}
+
+
+template < typename T >
+void Matrix< T >::check_same_size( const Matrix< T >& other ) const
+{
+     if ( rows_ != other.rows_ || cols_ != other.cols_ )
+     {
+          throw std::runtime_error{ "matrix sizes do not match" };
+     }
+}
+
+
+// one of the ring of the elements, from the first invertible one
+template < typename T >
+T Matrix< T >::one() const
+{
+     if constexpr ( Kernel::enabled )
+     {
+          if ( packed_ && Kernel::ring( ctx_ ) )
+          {
+               return Kernel::make( ctx_, 1 );
+          }
+     }
+     for ( size_t i = 0; i < rows_ * cols_; i++ )
+     {
+          T value = elem( i );
+          if ( !value )
+          {
+               continue;
+          }
+          try
+          {
+               return value * value.inv();
+          }
+          catch ( const std::runtime_error& )
+          {
+          }
+     }
+     throw std::runtime_error{ "matrix is singular" };
+}
+
+
+// the element at a row-major index, built from its word when packed
+template < typename T >
+T Matrix< T >::elem( size_t index ) const
+{
+     if constexpr ( Kernel::enabled )
+     {
+          if ( packed_ )
+          {
+               return Kernel::ring( ctx_ ) ? Kernel::make( ctx_, words_[ index ] ) : T{};
+          }
+     }
+     return elems_[ index ];
+}
+
+
+template < typename T >
+void Matrix< T >::assign( std::vector< T > elems )
+{
+     if constexpr ( Kernel::enabled )
+     {
+          context_type ctx{};
+          if ( std::all_of( elems.begin(), elems.end(), [ &ctx ]( const T& value ) { return fits( ctx, value ); } ) )
+          {
+               packed_ = true;
+               ctx_ = ctx;
+               words_.resize( elems.size() );
+               for ( size_t i = 0; i < elems.size(); i++ )
+               {
+                    words_[ i ] = Kernel::value( elems[ i ] );
+               }
+               elems_.clear();
+               return;
+          }
+     }
+     packed_ = false;
+     words_.clear();
+     elems_ = std::move( elems );
+}
+
+
+template < typename T >
+void Matrix< T >::unpack()
+{
+     if ( !packed_ )
+     {
+          return;
+     }
+     elems_ = elems();
+     packed_ = false;
+     ctx_ = context_type{};
+     words_.clear();
+}
+
+
+// context of two packed matrices, false if either holds elements or
+// they are packed under different contexts
+template < typename T >
+bool Matrix< T >::shared_context( const Matrix< T >& other, context_type& ctx ) const
+{
+     if ( !packed_ || !other.packed_ )
+     {
+          return false;
+     }
+     if ( !Kernel::ring( ctx_ ) || !Kernel::ring( other.ctx_ ) )
+     {
+          ctx = Kernel::ring( ctx_ ) ? ctx_ : other.ctx_;
+          return true;
+     }
+     ctx = ctx_;
+     return ctx_ == other.ctx_;
+}
+
+
+// joins value into ctx, false if it cannot be a word under the result
+template < typename T >
+bool Matrix< T >::fits( context_type& ctx, const T& value )
+{
+     context_type joined = ctx;
+     if ( !Kernel::join( joined, value ) || ( value && !Kernel::ring( joined ) ) )
+     {
+          return false;
+     }
+     ctx = joined;
+     return true;
+}
+
+template < typename T >
+Matrix< T > operator+ ( Matrix< T > a, const Matrix< T >& b ) { return a += b; }
+
+template < typename T >
+Matrix< T > operator- ( Matrix< T > a, const Matrix< T >& b ) { return a -= b; }
+
+template < typename T >
+Matrix< T > operator* ( Matrix< T > a, const Matrix< T >& b ) { return a *= b; }
+
+#endif // #ifndef MATRIX_H
@@ -0,0 +1,107 @@
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+
+#include <sets/residue.h>
+#include <sets/galois_2n.h>
+#include <sets/gf2_reducer.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// kernels on row-major arrays of raw values: residues in [0, modulo)
+// or GF(2^n) elements as words, n <= 64
+
+// c = a * b for an n x m matrix a and an m x p matrix b, c must not alias
+void matrix_mul( uint64_t* c, const uint64_t* a, const uint64_t* b,
+                 size_t n, size_t m, size_t p, uint64_t modulo );
+void matrix_mul( uint64_t* c, const uint64_t* a, const uint64_t* b,
+                 size_t n, size_t m, size_t p, const Gf2Reducer& field );
+
+// reduced row echelon form in place, returns the pivot columns;
+// the modulo must be prime
+std::vector< size_t > matrix_eliminate( uint64_t* a, size_t rows, size_t cols, uint64_t modulo );
+std::vector< size_t > matrix_eliminate( uint64_t* a, size_t rows, size_t cols, const Gf2Reducer& field );
+
+
+// access to raw values of element types the kernels handle, Matrix keeps
+// enabled types as raw values while its elements share a context
+template < typename T >
+struct MatrixKernel
+{
+     static constexpr bool enabled = false;
+     using context_type = bool;         // unused
+};
+
+
+template <>
+struct MatrixKernel< Residue >
+{
+     static constexpr bool enabled = true;
+     using context_type = uint64_t;     // common modulo, 0 while only zeroes are seen
+
+     static bool join( context_type& ctx, const Residue& elem )
+     {
+          if ( !elem )
+          {
+               return true;
+          }
+          ctx = ctx ? ctx : elem.get_modulo();
+          return ctx == elem.get_modulo();
+     }
+     static bool ring( context_type ctx ) { return ctx > 1; }
+     static bool field( context_type ctx ) { return ctx > 1 && Residue{ ctx }.is_field(); }
+     static uint64_t value( const Residue& elem ) { return elem.get_value(); }
+     static uint64_t add( context_type ctx, uint64_t a, uint64_t b ) { return ( a >= ctx - b ) ? a - ( ctx - b ) : a + b; }
+     static uint64_t sub( context_type ctx, uint64_t a, uint64_t b ) { return ( a >= b ) ? a - b : a + ( ctx - b ); }
+     static Residue make( context_type ctx, uint64_t value )
+     {
+          // values above the int64_t range go in as value - ctx
+          return Residue{ ctx, static_cast< int64_t >( ( value >> 63 ) ? value - ctx : value ) };
+     }
+     static void mul( context_type ctx, uint64_t* c, const uint64_t* a, const uint64_t* b, size_t n, size_t m, size_t p )
+     {
+          matrix_mul( c, a, b, n, m, p, ctx );
+     }
+     static std::vector< size_t > eliminate( context_type ctx, uint64_t* a, size_t rows, size_t cols )
+     {
+          return matrix_eliminate( a, rows, cols, ctx );
+     }
+};
+
+
+template <>
+struct MatrixKernel< Galois2N >
+{
+     static constexpr bool enabled = true;
+     using context_type = const Galois2NField*;
+
+     static bool join( context_type& ctx, const Galois2N& elem )
+     {
+          if ( !elem )
+          {
+               return true;
+          }
+          ctx = ctx ? ctx : elem.field();
+          return ctx == elem.field();
+     }
+     static bool ring( context_type ctx ) { return ctx && ctx->is_word(); }
+     static bool field( context_type ctx ) { return ring( ctx ); }
+     static uint64_t value( const Galois2N& elem ) { return elem ? elem.coeffs().to_ulong() : 0; }
+     static uint64_t add( context_type, uint64_t a, uint64_t b ) { return a ^ b; }
+     static uint64_t sub( context_type, uint64_t a, uint64_t b ) { return a ^ b; }
+     static Galois2N make( context_type ctx, uint64_t value )
+     {
+          return Galois2N{ ctx, Galois2N::polynom_type( ctx->degree(), value ) };
+     }
+     static void mul( context_type ctx, uint64_t* c, const uint64_t* a, const uint64_t* b, size_t n, size_t m, size_t p )
+     {
+          matrix_mul( c, a, b, n, m, p, ctx->reducer() );
+     }
+     static std::vector< size_t > eliminate( context_type ctx, uint64_t* a, size_t rows, size_t cols )
+     {
+          return matrix_eliminate( a, rows, cols, ctx->reducer() );
+     }
+};
+
+#endif // #ifndef MATRIX_KERNELS_H
@@ -2,6 +2,7 @@
 #define BUCHBERGER_H
 
 #include <polynomial/polynom.h>
+#include <sets/batch_inv.h>
 
 #include <stdexcept>
 #include <algorithm>
@@ -165,7 +166,7 @@ void reduce_basis( std::vector< Polynom >& pols ) {
 		Polynom rem = pol.mod( current );
 		if ( rem )
           {
-               pols[ i ] = rem / rem.leading_coeff();
+               pols[ i ] = rem;    // remainders don't depend on divisors' scale
                i++;
           }
           else
@@ -173,6 +174,21 @@ void reduce_basis( std::vector< Polynom >& pols ) {
                pols.erase( pols.begin() + i );
           }
      } while ( i < pols.size() );
+     // make polynomials monic with a single inversion
+     std::vector< typename Polynom::coeff_type > lead_inv;
+     lead_inv.reserve( pols.size() );
+     for ( const auto& pol : pols )
+     {
+          lead_inv.push_back( pol.leading_coeff() );
+     }
+     if ( !batch_inv( lead_inv ).empty() )
+     {
+          throw std::runtime_error{ "not invertible element" };
+     }
+     for ( size_t j = 0; j < pols.size(); j++ )
+     {
+          pols[ j ] *= lead_inv[ j ];
+     }
 }
 
 #endif	// #ifndef BUCHBERGER_H
@@ -1,13 +1,40 @@
 #ifndef MONOM_H
 #define MONOM_H
 
+#include <polynomial/poly_ring.h>
+
+#include <cstdint>
 #include <map>
 #include <string>
+#include <type_traits>
+#include <vector>
+
+// width of a monomial exponent, 8, 16 or 32 bits; 32 by default, narrower
+// exponents keep more monomials in cache for builds that know their
+// degrees stay small; operations throw when one overflows
+#ifndef KAM_MONOM_EXPONENT_BITS
+#define KAM_MONOM_EXPONENT_BITS 32
+#endif
+
+static_assert( KAM_MONOM_EXPONENT_BITS == 8 || KAM_MONOM_EXPONENT_BITS == 16 || KAM_MONOM_EXPONENT_BITS == 32,
+               "KAM_MONOM_EXPONENT_BITS must be 8, 16 or 32" );
 
+// product of variables of a ring as an exponent vector indexed by the
+// ring's variable indices, without trailing zeroes; the monomial 1 has
+// no exponents and combines with monomials of any ring. The divmask has
+// bit i % 64 set when some variable i occurs, so a monomial whose mask
+// is not covered by another's cannot divide it. The total degree is kept
+// up to date by every operation, so graded orders compare it in O(1)
 class Monom
 {
 public:
-     Monom( const std::map< std::string, size_t >& vars = {} ) noexcept;
+     using exponent_type = std::conditional_t< KAM_MONOM_EXPONENT_BITS == 8, uint8_t,
+                           std::conditional_t< KAM_MONOM_EXPONENT_BITS == 16, uint16_t, uint32_t > >;
+
+     // variables are interned in the default ring
+     Monom( const std::map< std::string, size_t >& vars = {} );
+     Monom( const PolyRing& ring, const std::map< std::string, size_t >& vars );
+     Monom( const PolyRing& ring, std::vector< exponent_type > exps );
      Monom( const Monom& other ) noexcept;
      Monom( Monom&& other ) noexcept;
 
@@ -21,13 +48,24 @@ public:
      void remove_var( const std::string& var );
      void set_deg( const std::string& var, size_t deg );
      size_t var_deg( const std::string& var ) const;
+     size_t var_deg( size_t index ) const;
      size_t full_deg() const;
      size_t var_count() const;
      bool is_divisible( const Monom& other ) const;
-     const std::map< std::string, size_t >& get_vars() const;
+     std::map< std::string, size_t > get_vars() const;
+     const PolyRing& ring() const;
+     const std::vector< exponent_type >& exps() const;
+     uint64_t divmask() const;
+     size_t hash() const;
 
 private:
-     std::map< std::string, size_t > vars_;
+     const PolyRing* ring_;
+     std::vector< exponent_type > exps_;
+     uint64_t divmask_;
+     size_t deg_;
+
+     void trim();
+     void join_ring( const Monom& other );
 };
 
 
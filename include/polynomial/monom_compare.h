@@ -1,35 +1,225 @@
 #ifndef MONOM_COMPARE_H
 #define MONOM_COMPARE_H
 
-class Monom;
+#include <polynomial/monom.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// variables by ascending name in the ring both monomials share, the
+// order all monomial orders rank variables in
+const std::vector< uint32_t >& variable_order( const Monom& lhs, const Monom& rhs );
+
+// every order also compares on a block first..last of variable_order,
+// giving the sign of lhs - rhs, so block orders can be built of them
 struct LexGreater
 {
      bool operator() ( const Monom& lhs, const Monom& rhs ) const;
+     static int compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last );
 };
 
 
 struct InvlexGreater
 {
      bool operator() ( const Monom& lhs, const Monom& rhs ) const;
+     static int compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last );
 };
 
 
 struct GrlexGreater
 {
      bool operator() ( const Monom& lhs, const Monom& rhs ) const;
+     static int compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last );
 };
 
 
 struct GrevlexGreater
 {
      bool operator() ( const Monom& lhs, const Monom& rhs ) const;
+     static int compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last );
 };
 
 
 struct RinvlexGreater
+{
+     bool operator() ( const Monom& lhs, const Monom& rhs ) const;
+     static int compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last );
+};
+
+
+// variables an order singles out, named by a type such as
+//   struct Eliminated { static constexpr const char* names[] = { "t", "s" }; };
+// and looked up in the ring of the monomials compared; names a ring does
+// not have yet are skipped, as no monomial of it can contain them
+template < typename Vars >
+struct NamedVars
+{
+     static constexpr size_t count = sizeof( Vars::names ) / sizeof( Vars::names[ 0 ] );
+
+     // index of each name in ring or PolyRing::npos, cached per thread
+     // until the ring gets new variables
+     static const std::vector< size_t >& indices( const PolyRing& ring );
+     // indices of the named and of the other variables, each by name
+     static const std::vector< uint32_t >& named( const PolyRing& ring );
+     static const std::vector< uint32_t >& others( const PolyRing& ring );
+
+private:
+     struct Cache
+     {
+          uint64_t ring_id = static_cast< uint64_t >( -1 );
+          size_t size = 0;
+          std::vector< size_t > indices;
+          std::vector< uint32_t > named;
+          std::vector< uint32_t > others;
+     };
+
+     static const Cache& cache( const PolyRing& ring );
+};
+
+
+// a row of weights for the variables of Vars in the order they are
+// named, the other variables weigh zero
+template < int64_t... Weights >
+struct WeightRow {};
+
+
+// the weighted degrees of the rows decide in turn, lex breaks ties; with
+// positive first nonzero weights in every column it is a monomial order
+template < typename Vars, typename... Rows >
+struct MatrixGreater
+{
+     bool operator() ( const Monom& lhs, const Monom& rhs ) const;
+     // rows only weigh the named variables inside first..last
+     static int compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last );
+
+private:
+     template < int64_t... Weights >
+     static int compare_row( const Monom& lhs, const Monom& rhs, const std::vector< size_t >& indices, size_t ring_size,
+                             const uint32_t* first, const uint32_t* last, WeightRow< Weights... > );
+};
+
+
+// weighted degree, then lex
+template < typename Vars, int64_t... Weights >
+struct WeightedGreater : MatrixGreater< Vars, WeightRow< Weights... > > {};
+
+
+// elimination order: the variables of Vars decide by FirstOrder, ties
+// are broken by RestOrder on the others
+template < typename Vars, typename FirstOrder = GrevlexGreater, typename RestOrder = GrevlexGreater >
+struct BlockGreater
 {
      bool operator() ( const Monom& lhs, const Monom& rhs ) const;
 };
 
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+template < typename Vars >
+const std::vector< size_t >& NamedVars< Vars >::indices( const PolyRing& ring )
+{
+     return cache( ring ).indices;
+}
+
+
+template < typename Vars >
+const std::vector< uint32_t >& NamedVars< Vars >::named( const PolyRing& ring )
+{
+     return cache( ring ).named;
+}
+
+
+template < typename Vars >
+const std::vector< uint32_t >& NamedVars< Vars >::others( const PolyRing& ring )
+{
+     return cache( ring ).others;
+}
+
+
+// the ring only gains variables and keeps their indices, so the cache is
+// current while the ring id and its size are unchanged
+template < typename Vars >
+const typename NamedVars< Vars >::Cache& NamedVars< Vars >::cache( const PolyRing& ring )
+{
+     thread_local Cache cached;
+     const auto& order = ring.order();
+     if ( cached.ring_id == ring.id() && cached.size == order.size() )
+     {
+          return cached;
+     }
+     cached.ring_id = ring.id();
+     cached.size = order.size();
+     cached.indices.clear();
+     for ( size_t i = 0; i < count; i++ )
+     {
+          size_t index = ring.find( Vars::names[ i ] );
+          cached.indices.push_back( ( index < order.size() ) ? index : PolyRing::npos );
+     }
+     cached.named.clear();
+     cached.others.clear();
+     for ( auto index : order )
+     {
+          bool is_named = std::find( cached.indices.begin(), cached.indices.end(), index ) != cached.indices.end();
+          ( is_named ? cached.named : cached.others ).push_back( index );
+     }
+     return cached;
+}
+
+
+template < typename Vars, typename... Rows >
+bool MatrixGreater< Vars, Rows... >::operator() ( const Monom& lhs, const Monom& rhs ) const
+{
+     const auto& order = variable_order( lhs, rhs );
+     return compare( lhs, rhs, order.data(), order.data() + order.size() ) > 0;
+}
+
+
+template < typename Vars, typename... Rows >
+int MatrixGreater< Vars, Rows... >::compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last )
+{
+     const PolyRing& ring = lhs.exps().empty() ? rhs.ring() : lhs.ring();
+     const auto& indices = NamedVars< Vars >::indices( ring );
+     [[maybe_unused]] size_t ring_size = ring.size();
+     int result = 0;
+     static_cast< void >( ( ( ( result = compare_row( lhs, rhs, indices, ring_size, first, last, Rows{} ) ) != 0 ) || ... ) );
+     return result ? result : LexGreater::compare( lhs, rhs, first, last );
+}
+
+
+template < typename Vars, typename... Rows >
+template < int64_t... Weights >
+int MatrixGreater< Vars, Rows... >::compare_row( const Monom& lhs, const Monom& rhs, const std::vector< size_t >& indices,
+                                                 size_t ring_size, const uint32_t* first, const uint32_t* last, WeightRow< Weights... > )
+{
+     constexpr int64_t weights[] = { Weights..., 0 };
+     constexpr size_t count = sizeof...( Weights );
+     // a range as long as the ring's variables is all of them
+     bool whole = static_cast< size_t >( last - first ) >= ring_size;
+     int64_t diff = 0;
+     for ( size_t i = 0; i < count && i < indices.size(); i++ )
+     {
+          size_t index = indices[ i ];
+          if ( index == PolyRing::npos || ( !whole && std::find( first, last, index ) == last ) )
+          {
+               continue;
+          }
+          diff += weights[ i ] * ( static_cast< int64_t >( lhs.var_deg( index ) ) -
+                                   static_cast< int64_t >( rhs.var_deg( index ) ) );
+     }
+     return ( diff > 0 ) - ( diff < 0 );
+}
+
+
+template < typename Vars, typename FirstOrder, typename RestOrder >
+bool BlockGreater< Vars, FirstOrder, RestOrder >::operator() ( const Monom& lhs, const Monom& rhs ) const
+{
+     const PolyRing& ring = lhs.exps().empty() ? rhs.ring() : lhs.ring();
+     variable_order( lhs, rhs );     // checks the rings
+     const auto& named = NamedVars< Vars >::named( ring );
+     const auto& others = NamedVars< Vars >::others( ring );
+     int result = FirstOrder::compare( lhs, rhs, named.data(), named.data() + named.size() );
+     return ( result ? result : RestOrder::compare( lhs, rhs, others.data(), others.data() + others.size() ) ) > 0;
+}
+
 #endif // #ifndef MONOM_COMPARE_H
@@ -0,0 +1,59 @@
+#ifndef NTT_H
+#define NTT_H
+
+#include <sets/residue.h>
+#include <sets/static_residue.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Polynom multiplication takes the transform path for at least ntt_min_pairs
+// term pairs when the dense image is at most ntt_max_size long and
+// size * log2( size ) <= ntt_density * pairs
+constexpr size_t ntt_min_pairs = 4096;
+constexpr size_t ntt_max_size  = size_t{ 1 } << 26;
+constexpr size_t ntt_density   = 4;
+
+// true if modulo is a prime c * 2^k + 1 with 2^k >= size, so the
+// number-theoretic transform of that size exists (998244353, 469762049...)
+bool ntt_supported( uint64_t modulo, size_t size );
+
+// product of dense coefficient vectors (index is the degree),
+// values must be in [0, modulo), ntt_supported must hold for
+// the result size a.size() + b.size() - 1
+std::vector< uint64_t > ntt_multiply( const std::vector< uint64_t >& a,
+                                      const std::vector< uint64_t >& b, uint64_t modulo );
+
+
+// access to raw residues of coefficient types usable with the transform,
+// Polynom multiplication takes the dense path only for enabled types
+template < typename CoeffType >
+struct NttCoeff
+{
+     static constexpr bool enabled = false;
+};
+
+
+template <>
+struct NttCoeff< Residue >
+{
+     static constexpr bool enabled = true;
+
+     static uint64_t modulo( const Residue& coeff ) { return coeff.get_modulo(); }
+     static uint64_t value( const Residue& coeff ) { return coeff.get_value(); }
+     static Residue make( uint64_t modulo, uint64_t value ) { return Residue{ modulo, static_cast< int64_t >( value ) }; }
+};
+
+
+template < uint64_t Modulo >
+struct NttCoeff< StaticResidue< Modulo > >
+{
+     static constexpr bool enabled = true;
+
+     static uint64_t modulo( const StaticResidue< Modulo >& ) { return Modulo; }
+     static uint64_t value( const StaticResidue< Modulo >& coeff ) { return coeff.get_value(); }
+     static StaticResidue< Modulo > make( uint64_t, uint64_t value ) { return { static_cast< int64_t >( value ) }; }
+};
+
+#endif // #ifndef NTT_H
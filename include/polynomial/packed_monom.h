@@ -0,0 +1,46 @@
+#ifndef PACKED_MONOM_H
+#define PACKED_MONOM_H
+
+#include <polynomial/monom.h>
+
+#include <cstdint>
+#include <cstddef>
+
+// exponents of the first vars (at most 64) variables of a ring packed
+// into two words, half of the fields in each; every field keeps its top
+// bit clear as a guard, so multiplication is one add per word and
+// divisibility one subtract per word. Monomials of other layouts, with
+// more variables or higher exponents than the fields hold, do not pack
+class PackedMonom
+{
+public:
+     static constexpr size_t max_vars = 64;
+
+     explicit PackedMonom( size_t vars = 0 );
+
+     bool assign( const Monom& monom );       // false if monom does not fit
+     Monom unpack( const PolyRing& ring ) const;
+
+     PackedMonom& operator*= ( const PackedMonom& other );
+     bool operator== ( const PackedMonom& other ) const;
+     bool operator!= ( const PackedMonom& other ) const;
+
+     bool is_divisible( const PackedMonom& other ) const;
+     size_t var_deg( size_t index ) const;
+     size_t vars() const;
+     unsigned field_bits() const;
+
+private:
+     uint64_t words_[ 2 ];
+     uint64_t guards_;
+     uint32_t vars_;
+     uint32_t per_word_;
+     unsigned bits_;
+
+     void check_layout( const PackedMonom& other ) const;
+};
+
+
+PackedMonom operator* ( PackedMonom lhs, const PackedMonom& rhs );
+
+#endif // #ifndef PACKED_MONOM_H
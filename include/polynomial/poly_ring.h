@@ -0,0 +1,58 @@
+#ifndef POLY_RING_H
+#define POLY_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// variables of a polynomial ring: names are interned to dense indices
+// that Monom exponent vectors are addressed by; monomial orders rank
+// variables by name, as order() lists them, whatever the index order.
+// The table only grows: interning a new name publishes a new snapshot
+// of it, lookups read the current snapshot without locking, and every
+// snapshot lives as long as the ring, so references handed out stay
+// valid. Copying the table per new name suits rings of up to a few
+// hundred variables
+class PolyRing
+{
+public:
+     static constexpr size_t npos = static_cast< size_t >( -1 );
+
+     explicit PolyRing( const std::vector< std::string >& vars = {} );
+     // ring of monomials built from variable names alone
+     static const PolyRing& default_ring();
+
+     PolyRing( const PolyRing& ) = delete;
+     PolyRing& operator= ( const PolyRing& ) = delete;
+
+     size_t intern( const std::string& var ) const;      // index, added if new
+     size_t find( const std::string& var ) const;        // index or npos
+     const std::string& name( size_t index ) const;
+     size_t size() const;
+     const std::vector< uint32_t >& order() const;      // indices by ascending name
+     uint64_t id() const;                               // unique among all rings
+
+private:
+     struct Table
+     {
+          std::map< std::string_view, uint32_t, std::less<> > index;
+          std::vector< const std::string* > names;
+          std::vector< uint32_t > order;
+     };
+
+     mutable std::atomic< const Table* >                table_;
+     mutable std::vector< std::unique_ptr< const Table > > tables_;   // all published
+     mutable std::deque< std::string >                  names_;    // references stay valid
+     mutable std::mutex                                 mutex_;    // writers only
+     uint64_t                                           id_;
+};
+
+#endif // #ifndef POLY_RING_H
@@ -3,7 +3,12 @@
 
 #include <polynomial/monom_compare.h>
 #include <polynomial/monom.h>
+#include <polynomial/packed_monom.h>
+#include <polynomial/term_accumulator.h>
+#include <polynomial/ntt.h>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <vector>
 #include <string>
@@ -42,6 +47,9 @@ public:
 
 private:
      std::map< Monom, CoeffType, Compare > terms_;
+
+     bool mul_dense( const Polynom& other );
+     void mul_term( const Polynom& pol, const std::pair< const Monom, CoeffType >& term );
 };
 
 
@@ -170,21 +178,162 @@ template < typename CoeffType, typename Compare >
 Polynom< CoeffType, Compare >& Polynom< CoeffType, Compare >::operator*=
 ( const Polynom< CoeffType, Compare >& other )
 {
-     Polynom< CoeffType, Compare > result;
+     if constexpr ( NttCoeff< CoeffType >::enabled )
+     {
+          if ( mul_dense( other ) )
+          {
+               return *this;
+          }
+     }
+     if ( terms_.size() == 1 || other.terms_.size() == 1 )
+     {
+          mul_term( terms_.size() == 1 ? other : *this, terms_.size() == 1 ? *terms_.cbegin() : *other.terms_.cbegin() );
+          return *this;
+     }
+     TermAccumulator< CoeffType > result{ terms_.size() + other.terms_.size() };
      for ( const auto& this_term : terms_ )
      {
           for ( const auto& other_term : other.terms_ )
           {
-               auto coeff = this_term.first * other_term.first;
-               auto& val = result.terms_[ coeff ] += this_term.second * other_term.second;
-               if ( !val )
+               result.add( this_term.first * other_term.first, this_term.second * other_term.second );
+          }
+     }
+     terms_ = result.template terms< Compare >();
+     return *this;
+}
+
+
+// monomial orders are compatible with multiplication, so the product of
+// pol by one term comes out sorted and is appended at the end of the map
+template < typename CoeffType, typename Compare >
+void Polynom< CoeffType, Compare >::mul_term
+( const Polynom< CoeffType, Compare >& pol, const std::pair< const Monom, CoeffType >& term )
+{
+     std::map< Monom, CoeffType, Compare > terms;
+     for ( const auto& pol_term : pol.terms_ )
+     {
+          auto coeff = pol_term.second * term.second;
+          if ( coeff )
+          {
+               terms.emplace_hint( terms.end(), pol_term.first * term.first, std::move( coeff ) );
+          }
+     }
+     terms_ = std::move( terms );
+}
+
+
+// Kronecker substitution: each variable becomes a mixed radix digit wide
+// enough for its degree in the product, then the dense univariate images
+// are multiplied with the number-theoretic transform
+template < typename CoeffType, typename Compare >
+bool Polynom< CoeffType, Compare >::mul_dense( const Polynom< CoeffType, Compare >& other )
+{
+     using traits = NttCoeff< CoeffType >;
+     size_t pairs = terms_.size() * other.terms_.size();
+     if ( terms_.empty() || other.terms_.empty() || pairs < ntt_min_pairs )
+     {
+          return false;
+     }
+     uint64_t modulo = traits::modulo( terms_.cbegin()->second );
+     // max degrees per variable index in both operands, the ring of the
+     // first monomial that has variables
+     const PolyRing* ring = nullptr;
+     std::vector< std::pair< size_t, size_t > > degs;
+     auto collect = [ & ]( const Polynom< CoeffType, Compare >& pol, bool second )
+     {
+          for ( const auto& term : pol.terms_ )
+          {
+               const auto& exps = term.first.exps();
+               if ( exps.empty() )
                {
-                    result.terms_.erase( coeff );
+                    continue;
+               }
+               if ( ring && ring != &term.first.ring() )
+               {
+                    return false;  // the schoolbook path reports the mismatch
+               }
+               ring = &term.first.ring();
+               if ( degs.size() < exps.size() )
+               {
+                    degs.resize( exps.size() );
+               }
+               for ( size_t i = 0; i < exps.size(); i++ )
+               {
+                    auto& deg = second ? degs[ i ].second : degs[ i ].first;
+                    deg = std::max< size_t >( deg, exps[ i ] );
                }
           }
+          return true;
+     };
+     if ( !collect( *this, false ) || !collect( other, true ) )
+     {
+          return false;
      }
-     *this = result;
-     return *this;
+     std::vector< size_t > strides;
+     size_t size = 1, log = 0;
+     for ( const auto& deg : degs )
+     {
+          size_t radix = deg.first + deg.second + 1;
+          if ( radix > size_t{ std::numeric_limits< Monom::exponent_type >::max() } + 1 || size > ntt_max_size / radix )
+          {
+               return false;
+          }
+          strides.push_back( size );
+          size *= radix;
+     }
+     while ( ( size_t{ 1 } << log ) < size )
+     {
+          log++;
+     }
+     if ( size * log > ntt_density * pairs || !ntt_supported( modulo, size ) )
+     {
+          return false;
+     }
+     auto to_dense = [ & ]( const Polynom< CoeffType, Compare >& pol, std::vector< uint64_t >& dense )
+     {
+          for ( const auto& term : pol.terms_ )
+          {
+               if ( traits::modulo( term.second ) != modulo )
+               {
+                    return false;  // the schoolbook path reports the mismatch
+               }
+               size_t index = 0;
+               const auto& exps = term.first.exps();
+               for ( size_t i = 0; i < exps.size(); i++ )
+               {
+                    index += exps[ i ] * strides[ i ];
+               }
+               if ( index >= dense.size() )
+               {
+                    dense.resize( index + 1, 0 );
+               }
+               dense[ index ] = traits::value( term.second );
+          }
+          return true;
+     };
+     std::vector< uint64_t > lhs, rhs;
+     if ( !to_dense( *this, lhs ) || !to_dense( other, rhs ) )
+     {
+          return false;
+     }
+     auto product = ntt_multiply( lhs, rhs, modulo );
+     std::map< Monom, CoeffType, Compare > terms;
+     std::vector< Monom::exponent_type > exps( strides.size() );
+     for ( size_t index = 0; index < product.size(); index++ )
+     {
+          if ( product[ index ] == 0 )
+          {
+               continue;
+          }
+          for ( size_t i = strides.size(), rest = index; i-- > 0; )
+          {
+               exps[ i ] = static_cast< Monom::exponent_type >( rest / strides[ i ] );
+               rest %= strides[ i ];
+          }
+          terms.emplace( Monom{ ring ? *ring : PolyRing::default_ring(), exps }, traits::make( modulo, product[ index ] ) );
+     }
+     terms_ = std::move( terms );
+     return true;
 }
 
 
@@ -257,17 +406,54 @@ template < typename CoeffType, typename Compare >
 Polynom< CoeffType, Compare > Polynom< CoeffType, Compare >::mod
 ( const std::vector< Polynom< CoeffType, Compare > >& divs ) const
 {
+     // leading monomials of the divisors packed once when they fit and share
+     // a ring; the dividend only gets variables of *this and the divisors
+     size_t vars = 0;
+     const PolyRing* ring = nullptr;
+     bool packed = true;
+     auto visit = [ & ]( const Monom& monom )
+     {
+          if ( monom.exps().empty() )
+          {
+               return;
+          }
+          vars = std::max( vars, monom.exps().size() );
+          packed = packed && ( !ring || ring == &monom.ring() );
+          ring = &monom.ring();
+     };
+     for ( const auto& term : terms_ )
+     {
+          visit( term.first );
+     }
+     std::vector< Monom > div_leads;
+     for ( const auto& div : divs )
+     {
+          div_leads.push_back( div.leading_monom() );
+          visit( div_leads.back() );
+     }
+     packed = packed && vars <= PackedMonom::max_vars;
+     std::vector< PackedMonom > packed_leads;
+     PackedMonom packed_lead{ packed ? vars : 0 };
+     for ( size_t i = 0; packed && i < divs.size(); i++ )
+     {
+          packed_leads.emplace_back( vars );
+          packed = packed_leads.back().assign( div_leads[ i ] );
+     }
+
      Polynom< CoeffType, Compare > rem, dividend{ *this };
      while ( dividend )
      {
           size_t i = 0;
           bool had_division = false;
+          const Monom& lead = dividend.terms_.cbegin()->first;
+          bool packed_dividend = packed && packed_lead.assign( lead );
           while ( i < divs.size() && !had_division )
           {
-               if ( dividend.leading_monom().is_divisible( divs[ i ].leading_monom() ) )
+               if ( packed_dividend ? packed_lead.is_divisible( packed_leads[ i ] )
+                                    : lead.is_divisible( div_leads[ i ] ) )
                {
                     Polynom< CoeffType, Compare > tmp {
-                         { { dividend.leading_monom() / divs[i].leading_monom(),
+                         { { lead / div_leads[ i ],
                            dividend.leading_coeff() / divs[i].leading_coeff() } }
                     };
                     dividend -= tmp * divs[i];
@@ -297,12 +483,24 @@ Polynom< CoeffType, Compare > Polynom< CoeffType, Compare >::subst
      {
           return *this;
      }
-     Polynom< CoeffType, Compare > ret;
+     // powers of pol are shared by the terms of equal degree in var
+     std::map< size_t, Polynom< CoeffType, Compare > > powers;
+     TermAccumulator< CoeffType > sum{ terms_.size() };
      for ( std::pair< Monom, CoeffType > term : terms_ ) {
           size_t deg = term.first.var_deg( var );
           term.first.remove_var( var );
-          ret += pow(pol, deg) * Polynom< CoeffType, Compare >{ { { term.first, term.second } } };
+          auto power = powers.find( deg );
+          if ( power == powers.end() )
+          {
+               power = powers.emplace( deg, pow( pol, deg ) ).first;
+          }
+          for ( const auto& pol_term : power->second.terms_ )
+          {
+               sum.add( pol_term.first * term.first, pol_term.second * term.second );
+          }
      }
+     Polynom< CoeffType, Compare > ret;
+     ret.terms_ = sum.template terms< Compare >();
      return ret;
 }
 
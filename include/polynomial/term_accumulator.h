@@ -0,0 +1,147 @@
+#ifndef TERM_ACCUMULATOR_H
+#define TERM_ACCUMULATOR_H
+
+#include <polynomial/monom.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+// sums terms in an open-addressing table keyed by the monomial hash, so
+// collecting a large product compares no monomials; terms() sorts what
+// is left by the monomial order once. Terms that cancel stay in the
+// table as zeroes and are dropped by terms()
+template < typename CoeffType >
+class TermAccumulator
+{
+public:
+     explicit TermAccumulator( size_t expected = 0 );
+
+     void add( Monom monom, const CoeffType& coeff );
+     size_t size() const;
+
+     // nonzero terms ordered by Compare, the accumulator is left empty
+     template < typename Compare >
+     std::map< Monom, CoeffType, Compare > terms();
+
+private:
+     std::vector< std::pair< Monom, CoeffType > > terms_;
+     std::vector< size_t > hashes_;
+     std::vector< size_t > slots_;       // 1 + index into terms_, 0 if free
+     size_t mask_;
+
+     size_t& slot( const Monom& monom, size_t hash );
+     void grow();
+};
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+template < typename CoeffType >
+TermAccumulator< CoeffType >::TermAccumulator( size_t expected )
+{
+     size_t size = 16;
+     while ( size < 2 * expected )
+     {
+          size *= 2;
+     }
+     slots_.assign( size, 0 );
+     mask_ = size - 1;
+     terms_.reserve( expected );
+     hashes_.reserve( expected );
+}
+
+
+template < typename CoeffType >
+void TermAccumulator< CoeffType >::add( Monom monom, const CoeffType& coeff )
+{
+     size_t hash = monom.hash();
+     size_t& found = slot( monom, hash );
+     if ( found )
+     {
+          terms_[ found - 1 ].second += coeff;
+          return;
+     }
+     found = terms_.size() + 1;
+     terms_.emplace_back( std::move( monom ), coeff );
+     hashes_.push_back( hash );
+     grow();
+}
+
+
+template < typename CoeffType >
+size_t TermAccumulator< CoeffType >::size() const
+{
+     return terms_.size();
+}
+
+
+template < typename CoeffType >
+template < typename Compare >
+std::map< Monom, CoeffType, Compare > TermAccumulator< CoeffType >::terms()
+{
+     std::vector< size_t > order;
+     order.reserve( terms_.size() );
+     for ( size_t i = 0; i < terms_.size(); i++ )
+     {
+          if ( terms_[ i ].second )
+          {
+               order.push_back( i );
+          }
+     }
+     Compare compare;
+     std::sort( order.begin(), order.end(), [ & ]( size_t lhs, size_t rhs )
+     {
+          return compare( terms_[ lhs ].first, terms_[ rhs ].first );
+     } );
+     // sorted input makes every hinted insertion constant time
+     std::map< Monom, CoeffType, Compare > result;
+     for ( auto i : order )
+     {
+          result.emplace_hint( result.end(), std::move( terms_[ i ] ) );
+     }
+     terms_.clear();
+     hashes_.clear();
+     std::fill( slots_.begin(), slots_.end(), 0 );
+     return result;
+}
+
+
+// linear probing: the slot holding monom or the free slot it would take
+template < typename CoeffType >
+size_t& TermAccumulator< CoeffType >::slot( const Monom& monom, size_t hash )
+{
+     for ( size_t i = hash & mask_; ; i = ( i + 1 ) & mask_ )
+     {
+          size_t index = slots_[ i ];
+          if ( !index || ( hashes_[ index - 1 ] == hash && terms_[ index - 1 ].first == monom ) )
+          {
+               return slots_[ i ];
+          }
+     }
+}
+
+
+// keeps the table at most half full
+template < typename CoeffType >
+void TermAccumulator< CoeffType >::grow()
+{
+     if ( 2 * terms_.size() <= slots_.size() )
+     {
+          return;
+     }
+     slots_.assign( 2 * slots_.size(), 0 );
+     mask_ = slots_.size() - 1;
+     for ( size_t index = 0; index < terms_.size(); index++ )
+     {
+          size_t i = hashes_[ index ] & mask_;
+          while ( slots_[ i ] )
+          {
+               i = ( i + 1 ) & mask_;
+          }
+          slots_[ i ] = index + 1;
+     }
+}
+
+#endif // #ifndef TERM_ACCUMULATOR_H
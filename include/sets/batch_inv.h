@@ -0,0 +1,82 @@
+#ifndef BATCH_INV_H
+#define BATCH_INV_H
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+// inverts elems[ 0 .. count ) in place with Montgomery's trick: one inv()
+// and 3(n-1) multiplications; returns indices of elements that are not
+// invertible, they are left unchanged. T is Residue, Galois2N or another
+// type with the same interface. If the total product is not invertible
+// (a zero divisor in a non-field ring), every nonzero element is
+// inverted separately to find the culprits
+template < typename T >
+std::vector< size_t > batch_inv( T* elems, size_t count );
+
+template < typename T >
+std::vector< size_t > batch_inv( std::vector< T >& elems );
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+template < typename T >
+std::vector< size_t > batch_inv( T* elems, size_t count )
+{
+     std::vector< size_t > failed, nonzero;
+     std::vector< T > prefix;      // prefix[ k ] = product of first k + 1 nonzero elements
+     nonzero.reserve( count );
+     prefix.reserve( count );
+     for ( size_t i = 0; i < count; i++ )
+     {
+          if ( !elems[ i ] )
+          {
+               failed.push_back( i );
+               continue;
+          }
+          prefix.push_back( prefix.empty() ? elems[ i ] : prefix.back() * elems[ i ] );
+          nonzero.push_back( i );
+     }
+     if ( nonzero.empty() )
+     {
+          return failed;
+     }
+     T acc;
+     try
+     {
+          acc = prefix.back().inv();
+     }
+     catch ( const std::runtime_error& )
+     {
+          for ( auto i : nonzero )
+          {
+               try
+               {
+                    elems[ i ] = elems[ i ].inv();
+               }
+               catch ( const std::runtime_error& )
+               {
+                    failed.push_back( i );
+               }
+          }
+          std::sort( failed.begin(), failed.end() );
+          return failed;
+     }
+     for ( size_t k = nonzero.size() - 1; k > 0; k-- )
+     {
+          T& elem = elems[ nonzero[ k ] ];
+          T elem_inv = acc * prefix[ k - 1 ];
+          acc *= elem;
+          elem = std::move( elem_inv );
+     }
+     elems[ nonzero.front() ] = std::move( acc );
+     return failed;
+}
+
+
+template < typename T >
+std::vector< size_t > batch_inv( std::vector< T >& elems )
+{
+     return batch_inv( elems.data(), elems.size() );
+}
+
+#endif // #ifndef BATCH_INV_H
@@ -0,0 +1,48 @@
+#ifndef DISCRETE_LOG_H
+#define DISCRETE_LOG_H
+
+#include <sets/gf2_reducer.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// discrete logarithms in GF(2^n), n <= 64, to the base of the root x of
+// the field polynomial: Pohlig-Hellman over the factors of the order of x,
+// baby-step giant-step in the small prime subgroups with tables kept for
+// the next query, Pollard's rho in the large ones
+class Gf2DiscreteLog
+{
+public:
+     // shared engine of the field, built on the first request
+     static const Gf2DiscreteLog& get( const Gf2Reducer& field );
+
+     uint64_t order() const;                // multiplicative order of x
+     // k < order() with x^k == a, throws if a is not a power of x
+     uint64_t log( uint64_t a ) const;
+
+     explicit Gf2DiscreteLog( const Gf2Reducer& field );
+
+private:
+     // subgroup of prime order p generated by x^( order / p )
+     struct Subgroup
+     {
+          uint64_t p = 0;
+          size_t   exp = 0;                                   // p^exp divides the order
+          uint64_t generator = 0;
+          uint64_t giant = 0;                                 // generator^-steps
+          uint64_t steps = 0;                                 // baby steps, 0 for Pollard's rho
+          std::vector< std::pair< uint64_t, uint64_t > > baby;  // ( generator^j, j ) sorted
+     };
+
+     Gf2Reducer field_;
+     uint64_t   root_;
+     uint64_t   order_;
+     std::vector< Subgroup > subgroups_;
+
+     uint64_t subgroup_log( const Subgroup& group, uint64_t h ) const;
+     uint64_t rho_log( const Subgroup& group, uint64_t h ) const;
+};
+
+#endif // #ifndef DISCRETE_LOG_H
@@ -1,6 +1,8 @@
 #ifndef GALOIS_2N_H
 #define GALOIS_2N_H
 
+#include <sets/galois_2n_field.h>
+
 #include <boost/dynamic_bitset.hpp>
 
 // element of a Galois field GF(2^n)
@@ -11,6 +13,8 @@ public:
 
 	explicit Galois2N( const polynom_type& irreducible = {}, const polynom_type& coeffs = {} ) noexcept;
      explicit Galois2N( const polynom_type& irreducible, size_t power ) noexcept;
+     Galois2N( const Galois2NField* field, const polynom_type& coeffs ) noexcept;
+     Galois2N( const Galois2NField* field, size_t power ) noexcept;
      Galois2N( const Galois2N& other ) noexcept;
      Galois2N( Galois2N&& other ) noexcept;
 
@@ -20,6 +24,7 @@ public:
      Galois2N& operator-= ( const Galois2N& other );
      Galois2N& operator*= ( const Galois2N& other );
      Galois2N& operator/= ( const Galois2N& other );
+     Galois2N& fma( const Galois2N& mul, const Galois2N& add );   // *this = *this * mul + add
      Galois2N operator- () const;  // unary minus
      bool operator== ( const Galois2N& other ) const;
      bool operator!= ( const Galois2N& other ) const;
@@ -31,19 +36,15 @@ public:
 
      Galois2N inv() const;
      size_t prim_power() const;
+     const Galois2NField* field() const;      // nullptr for the generic zero
      const polynom_type& irreducible_pol() const;
      const polynom_type& coeffs() const;
 
 private:
-     polynom_type irr_pol_;        // irreducible polynomial
+     const Galois2NField* field_;  // interned irreducible polynomial
      polynom_type basis_coeffs_;   // coefficients of a value in power
                                    // basis {a^n-1, ... a, 1}, where
                                    // a is a primitive element
-     // erase leading zeroes, polynomial's size will be >= size
-     static void shrink( polynom_type& pol, size_t size = 0 );
-     static void pol_mod( polynom_type& pol, const polynom_type& divisor );
-     static void pol_div( polynom_type& pol, const polynom_type& divisor );
-     static void pol_mul( polynom_type& pol, const polynom_type& mul );
 };
 
 
@@ -0,0 +1,51 @@
+#ifndef GALOIS_2N_FIELD_H
+#define GALOIS_2N_FIELD_H
+
+#include <sets/galois_table.h>
+#include <sets/gf2_reducer.h>
+#include <sets/gf2_wide_reducer.h>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <mutex>
+
+// immutable description of a field GF(2^n): the irreducible polynomial
+// and its reduction data; there is one instance per polynomial for the
+// whole process, so fields are compared and copied as pointers
+class Galois2NField
+{
+public:
+     using polynom_type = boost::dynamic_bitset<uint64_t>;
+
+     // interned field of the polynomial, leading zeroes are ignored;
+     // nullptr for the zero polynomial
+     static const Galois2NField* get( const polynom_type& irreducible );
+     // field of the lowest weight primitive polynomial of the degree,
+     // irreducible above degree 64 where primitivity is not checked
+     static const Galois2NField* get( size_t degree );
+
+     Galois2NField( const Galois2NField& ) = delete;
+     Galois2NField& operator= ( const Galois2NField& ) = delete;
+
+     size_t degree() const;
+     const polynom_type& irreducible_pol() const;
+     // word arithmetic, degree() <= 64 only
+     bool is_word() const;
+     const Gf2Reducer& reducer() const;
+     // multi-word arithmetic, any degree
+     const Gf2WideReducer& wide_reducer() const;
+     // log/antilog tables built on the first call, nullptr unless the
+     // degree is small and the polynomial primitive
+     const GaloisTable* table() const;
+
+private:
+     explicit Galois2NField( const polynom_type& irreducible );
+
+     polynom_type irr_pol_;
+     Gf2Reducer   reducer_;
+     Gf2WideReducer wide_reducer_;
+     mutable std::once_flag      table_once_;
+     mutable const GaloisTable*  table_ = nullptr;
+};
+
+#endif // #ifndef GALOIS_2N_FIELD_H
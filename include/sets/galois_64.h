@@ -0,0 +1,59 @@
+#ifndef GALOIS_64_H
+#define GALOIS_64_H
+
+#include <sets/galois_2n.h>
+#include <sets/galois_2n_field.h>
+
+#include <cstdint>
+#include <cstddef>
+
+// element of a Galois field GF(2^n) for n <= 64: the value is a machine
+// word and the field is the interned descriptor, multiplication is one
+// carry-less product and a Barrett reduction, so nothing is allocated
+class Galois64
+{
+public:
+     using polynom_type = Galois2N::polynom_type;
+
+     // field is nullptr or has degree() <= 64
+     explicit Galois64( const Galois2NField* field = nullptr, uint64_t coeffs = 0 ) noexcept;
+     explicit Galois64( const polynom_type& irreducible, const polynom_type& coeffs = {} );
+     explicit Galois64( const Galois2N& other );
+
+     Galois64& operator+= ( const Galois64& other );
+     Galois64& operator-= ( const Galois64& other );
+     Galois64& operator*= ( const Galois64& other );
+     Galois64& operator/= ( const Galois64& other );
+     Galois64 operator- () const;  // unary minus
+     bool operator== ( const Galois64& other ) const;
+     bool operator!= ( const Galois64& other ) const;
+     bool operator>  ( const Galois64& other ) const;
+     bool operator<  ( const Galois64& other ) const;
+     bool operator>= ( const Galois64& other ) const;
+     bool operator<= ( const Galois64& other ) const;
+     explicit operator bool() const;		// equivalent to *this != 0
+
+     Galois64 inv() const;
+     const Galois2NField* field() const;     // nullptr for the generic zero
+     uint64_t coeffs() const;            // bit i is the coefficient of a^i
+     Galois2N to_galois_2n() const;
+
+     // field of an irreducible polynomial given as a bitset, size() - 1 <= 64
+     static const Galois2NField* make_field( const polynom_type& irreducible );
+
+private:
+     const Galois2NField* field_;
+     uint64_t value_;
+
+     // zero adopts the field of the other operand, false if other is zero
+     bool check_field( const Galois64& other );
+};
+
+
+Galois64 operator+ ( Galois64 a, const Galois64& b );
+Galois64 operator- ( Galois64 a, const Galois64& b );
+Galois64 operator* ( Galois64 a, const Galois64& b );
+Galois64 operator/ ( Galois64 a, const Galois64& b );
+Galois64 pow( const Galois64& base, size_t exp );
+
+#endif // #ifndef GALOIS_64_H
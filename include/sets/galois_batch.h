@@ -0,0 +1,48 @@
+#ifndef GALOIS_BATCH_H
+#define GALOIS_BATCH_H
+
+#include <sets/galois_2n.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// elements of one field GF(2^n) in bitsliced form: plane i holds bit i
+// of every element, 64 elements per word; operations are element-wise
+// and run over all lanes at once with AND/XOR only, AVX-512 or AVX2 when
+// the CPU has it, so nothing branches on values or allocates per element
+class Galois2NBatch
+{
+public:
+     static constexpr size_t tile_words = 8;      // 512 lanes processed together
+
+     explicit Galois2NBatch( const Galois2NField* field = nullptr, size_t size = 0 );
+     explicit Galois2NBatch( const std::vector< Galois2N >& elems );
+
+     Galois2NBatch& operator+= ( const Galois2NBatch& other );
+     Galois2NBatch& operator-= ( const Galois2NBatch& other );
+     Galois2NBatch& operator*= ( const Galois2NBatch& other );
+     Galois2NBatch& square();
+
+     size_t size() const;
+     const Galois2NField* field() const;
+     Galois2N get( size_t i ) const;
+     void set( size_t i, const Galois2N& value );
+     std::vector< Galois2N > to_elements() const;
+
+private:
+     const Galois2NField*    field_;
+     size_t                  size_;
+     size_t                  groups_;   // words per plane, a multiple of tile_words
+     std::vector< uint64_t > planes_;   // plane i at [ i * groups_, ( i + 1 ) * groups_ )
+
+     size_t degree() const;
+     void check_compatible( const Galois2NBatch& other ) const;
+};
+
+
+Galois2NBatch operator+ ( Galois2NBatch a, const Galois2NBatch& b );
+Galois2NBatch operator- ( Galois2NBatch a, const Galois2NBatch& b );
+Galois2NBatch operator* ( Galois2NBatch a, const Galois2NBatch& b );
+
+#endif // #ifndef GALOIS_BATCH_H
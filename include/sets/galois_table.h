@@ -0,0 +1,82 @@
+#ifndef GALOIS_TABLE_H
+#define GALOIS_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// log/antilog tables of a small field GF(2^n), n <= max_degree, in the
+// base of the root a of the field polynomial; elements are words where
+// bit i is the coefficient of a^i, operands are in the field
+class GaloisTable
+{
+public:
+     static constexpr size_t max_degree = 16;
+
+     // shared table of f = x^degree + poly, built on the first request;
+     // nullptr if the degree is too large or a is not a primitive element
+     static const GaloisTable* get( size_t degree, uint64_t poly );
+
+     size_t order() const;              // 2^n - 1
+     size_t log( uint32_t a ) const;    // a != 0
+     uint32_t exp( size_t power ) const;
+     uint32_t mul( uint32_t a, uint32_t b ) const;
+     uint32_t div( uint32_t a, uint32_t b ) const;    // b != 0
+     uint32_t inv( uint32_t a ) const;                // a != 0
+     uint32_t pow( uint32_t a, size_t exp ) const;
+
+private:
+     std::vector< uint16_t > log_;      // log_[ a ] for a != 0
+     std::vector< uint16_t > exp_;      // a^i for i < 2 * order, sums of logs need no reduction
+
+     bool build( size_t degree, uint64_t poly );
+};
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+inline size_t GaloisTable::order() const
+{
+     return log_.size() - 1;
+}
+
+
+inline size_t GaloisTable::log( uint32_t a ) const
+{
+     return log_[ a ];
+}
+
+
+inline uint32_t GaloisTable::exp( size_t power ) const
+{
+     return exp_[ power % order() ];
+}
+
+
+inline uint32_t GaloisTable::mul( uint32_t a, uint32_t b ) const
+{
+     return ( a && b ) ? exp_[ log_[ a ] + log_[ b ] ] : 0;
+}
+
+
+inline uint32_t GaloisTable::div( uint32_t a, uint32_t b ) const
+{
+     return a ? exp_[ log_[ a ] + order() - log_[ b ] ] : 0;
+}
+
+
+inline uint32_t GaloisTable::inv( uint32_t a ) const
+{
+     return exp_[ order() - log_[ a ] ];
+}
+
+
+inline uint32_t GaloisTable::pow( uint32_t a, size_t exp ) const
+{
+     if ( !a )
+     {
+          return exp ? 0 : 1;
+     }
+     return exp_[ ( log_[ a ] * ( exp % order() ) ) % order() ];
+}
+
+#endif // #ifndef GALOIS_TABLE_H
@@ -0,0 +1,24 @@
+#ifndef GF2_POLYNOMIALS_H
+#define GF2_POLYNOMIALS_H
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+// field polynomials over GF(2): bit i is the coefficient of x^i,
+// leading zeroes are ignored
+
+// Rabin's test: x^2^n = x mod f and x^2^( n / q ) - x is prime to f
+// for every prime q dividing the degree n
+bool is_irreducible( const boost::dynamic_bitset< uint64_t >& pol );
+// irreducible and x generates the multiplicative group, degree <= 64
+bool is_primitive( const boost::dynamic_bitset< uint64_t >& pol );
+
+// x^n + x^k + 1 with the lowest k, otherwise x^n + x^a + x^b + x^c + 1
+// with the lowest ( a, b, c ), and so on by weight; found on the first
+// request for the degree and kept for the process
+const boost::dynamic_bitset< uint64_t >& irreducible_polynom( size_t degree );
+const boost::dynamic_bitset< uint64_t >& primitive_polynom( size_t degree );    // degree <= 64
+
+#endif // #ifndef GF2_POLYNOMIALS_H
@@ -0,0 +1,105 @@
+#ifndef GF2_REDUCER_H
+#define GF2_REDUCER_H
+
+#include <cstdint>
+#include <cstddef>
+
+// carry-less product of two words: polynomials over GF(2), bit i is the
+// coefficient of x^i; PCLMULQDQ when the CPU has it, a portable loop otherwise
+unsigned __int128 clmul( uint64_t a, uint64_t b );
+
+
+// arithmetic in GF(2)[x] / f for f = x^degree + poly, 1 <= degree <= 64,
+// deg poly < degree; elements are words with bits above degree clear;
+// Barrett reduction with mu = x^2degree / f costs two carry-less products
+class Gf2Reducer
+{
+public:
+     using wide_type = unsigned __int128;
+
+     constexpr explicit Gf2Reducer( size_t degree = 0, uint64_t poly = 0 ) noexcept;
+
+     constexpr size_t degree() const;
+     constexpr uint64_t poly() const;     // f without the leading term
+     constexpr uint64_t mask() const;     // all field bits set
+     constexpr uint64_t mu() const;       // x^2degree / f without the leading term
+     constexpr bool operator== ( const Gf2Reducer& other ) const;
+     constexpr bool operator!= ( const Gf2Reducer& other ) const;
+
+     uint64_t mul( uint64_t a, uint64_t b ) const;
+     uint64_t sqr( uint64_t a ) const;
+     uint64_t reduce( wide_type a ) const;    // deg a <= 2 * degree - 2
+     uint64_t inv( uint64_t a ) const;        // a != 0
+     uint64_t pow( uint64_t a, uint64_t exp ) const;
+
+private:
+     size_t   degree_;
+     uint64_t poly_;
+     uint64_t mu_;
+     uint64_t mask_;
+};
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+constexpr Gf2Reducer::Gf2Reducer( size_t degree, uint64_t poly ) noexcept:
+     degree_{ degree }, poly_{ 0 }, mu_{ 0 }, mask_{ 0 }
+{
+     if ( degree_ == 0 || degree_ > 64 )
+     {
+          degree_ = 0;
+          return;
+     }
+     mask_ = ( degree_ == 64 ) ? ~uint64_t{ 0 } : ( uint64_t{ 1 } << degree_ ) - 1;
+     poly_ = poly & mask_;
+     // long division of x^2degree by f, one dividend bit per step
+     uint64_t rem = 0;
+     for ( size_t i = 0; i <= 2 * degree_; i++ )
+     {
+          bool top = ( rem >> ( degree_ - 1 ) ) & 1;
+          rem = ( ( rem << 1 ) | ( i == 0 ) ) & mask_;
+          mu_ = ( mu_ << 1 ) | top;
+          if ( top )
+          {
+               rem ^= poly_;
+          }
+     }
+     mu_ &= mask_;
+}
+
+
+constexpr size_t Gf2Reducer::degree() const
+{
+     return degree_;
+}
+
+
+constexpr uint64_t Gf2Reducer::poly() const
+{
+     return poly_;
+}
+
+
+constexpr uint64_t Gf2Reducer::mask() const
+{
+     return mask_;
+}
+
+
+constexpr uint64_t Gf2Reducer::mu() const
+{
+     return mu_;
+}
+
+
+constexpr bool Gf2Reducer::operator== ( const Gf2Reducer& other ) const
+{
+     return degree_ == other.degree_ && poly_ == other.poly_;
+}
+
+
+constexpr bool Gf2Reducer::operator!= ( const Gf2Reducer& other ) const
+{
+     return !( *this == other );
+}
+
+#endif // #ifndef GF2_REDUCER_H
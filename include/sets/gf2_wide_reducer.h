@@ -0,0 +1,41 @@
+#ifndef GF2_WIDE_REDUCER_H
+#define GF2_WIDE_REDUCER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// arithmetic in GF(2)[x] / f for f = x^degree + poly of any degree;
+// elements are arrays of words(), bit i of word k is the coefficient
+// of x^( 64k + i ), bits from degree on are clear
+class Gf2WideReducer
+{
+public:
+     Gf2WideReducer() = default;
+     // poly holds f without the leading term, deg poly < degree
+     Gf2WideReducer( size_t degree, std::vector< uint64_t > poly );
+
+     size_t degree() const;
+     size_t words() const;
+
+     // wide is scratch of 2 * words() words, dst may alias operands
+     void mul( uint64_t* dst, const uint64_t* a, const uint64_t* b, uint64_t* wide ) const;
+     void sqr( uint64_t* dst, const uint64_t* a, uint64_t* wide ) const;
+     // wide holds a product of two elements and is clobbered
+     void reduce( uint64_t* dst, uint64_t* wide ) const;
+
+     // Itoh-Tsujii: a^-1 = ( a^( 2^( degree - 1 ) - 1 ) )^2, a != 0
+     void inv( uint64_t* dst, const uint64_t* a ) const;
+     void pow( uint64_t* dst, const uint64_t* a, size_t exp ) const;
+
+private:
+     size_t degree_ = 0;
+     size_t words_  = 0;
+     size_t chunk_  = 0;     // bits folded per step, their product with poly stays below them
+     std::vector< uint64_t > poly_;
+     std::vector< size_t >   taps_;  // exponents of a trinomial or pentanomial, else empty
+
+     void reduce_sparse( uint64_t* dst, uint64_t* wide ) const;
+};
+
+#endif // #ifndef GF2_WIDE_REDUCER_H
@@ -0,0 +1,163 @@
+#ifndef MOD_REDUCER_H
+#define MOD_REDUCER_H
+
+#include <cstdint>
+#include <cstddef>
+
+// modular arithmetic engine for a fixed modulus: Montgomery form
+// for odd moduli and Barrett reduction for even ones, both with
+// 128-bit intermediates, so no hardware division is needed
+class ModReducer
+{
+public:
+     using wide_type = unsigned __int128;
+
+     constexpr explicit ModReducer( uint64_t modulo = 0 ) noexcept;
+
+     constexpr uint64_t get_modulo() const;
+     constexpr bool is_montgomery() const;
+
+     // operands and results are in [0, modulo)
+     constexpr uint64_t add( uint64_t a, uint64_t b ) const;
+     constexpr uint64_t sub( uint64_t a, uint64_t b ) const;
+     constexpr uint64_t neg( uint64_t a ) const;
+     constexpr uint64_t mul( uint64_t a, uint64_t b ) const;
+
+     // internal form: Montgomery form a*2^64 mod m for odd moduli,
+     // plain value otherwise; chains of multiplications (powers,
+     // products) stay in it and convert only at the ends
+     constexpr uint64_t to_form( uint64_t a ) const;
+     constexpr uint64_t from_form( uint64_t a ) const;
+     constexpr uint64_t mul_form( uint64_t a, uint64_t b ) const;
+     constexpr uint64_t one_form() const;
+
+private:
+     uint64_t  modulo_;
+     uint64_t  inv_;     // modulo^-1 mod 2^64, Montgomery only
+     uint64_t  r2_;      // 2^128 mod modulo, Montgomery only
+     wide_type mu_;      // floor( (2^128 - 1) / modulo ), Barrett only
+
+     constexpr uint64_t redc( wide_type t ) const;
+     constexpr uint64_t barrett( wide_type t ) const;
+};
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+constexpr ModReducer::ModReducer( uint64_t modulo ) noexcept:
+     modulo_{ modulo }, inv_{ 0 }, r2_{ 0 }, mu_{ 0 }
+{
+     if ( modulo_ <= 1 )
+     {
+          return;
+     }
+     if ( modulo_ & 1 )
+     {
+          inv_ = modulo_;     // correct to 3 bits, each step doubles them
+          for ( size_t i = 0; i < 5; i++ )
+          {
+               inv_ *= 2 - modulo_ * inv_;
+          }
+          wide_type r = ( 0 - modulo_ ) % modulo_;     // 2^64 mod m
+          r2_ = static_cast< uint64_t >( ( r * r ) % modulo_ );
+     }
+     else
+     {
+          mu_ = ~wide_type{ 0 } / modulo_;
+     }
+}
+
+
+constexpr uint64_t ModReducer::get_modulo() const
+{
+     return modulo_;
+}
+
+
+constexpr bool ModReducer::is_montgomery() const
+{
+     return modulo_ & 1;
+}
+
+
+constexpr uint64_t ModReducer::add( uint64_t a, uint64_t b ) const
+{
+     return ( a >= modulo_ - b ) ? a - ( modulo_ - b ) : a + b;
+}
+
+
+constexpr uint64_t ModReducer::sub( uint64_t a, uint64_t b ) const
+{
+     return ( a >= b ) ? a - b : a + ( modulo_ - b );
+}
+
+
+constexpr uint64_t ModReducer::neg( uint64_t a ) const
+{
+     return a ? modulo_ - a : 0;
+}
+
+
+constexpr uint64_t ModReducer::mul( uint64_t a, uint64_t b ) const
+{
+     if ( is_montgomery() )
+     {
+          return redc( static_cast< wide_type >( redc( static_cast< wide_type >( a ) * b ) ) * r2_ );
+     }
+     return barrett( static_cast< wide_type >( a ) * b );
+}
+
+
+constexpr uint64_t ModReducer::to_form( uint64_t a ) const
+{
+     return is_montgomery() ? redc( static_cast< wide_type >( a ) * r2_ ) : a;
+}
+
+
+constexpr uint64_t ModReducer::from_form( uint64_t a ) const
+{
+     return is_montgomery() ? redc( a ) : a;
+}
+
+
+constexpr uint64_t ModReducer::mul_form( uint64_t a, uint64_t b ) const
+{
+     wide_type t = static_cast< wide_type >( a ) * b;
+     return is_montgomery() ? redc( t ) : barrett( t );
+}
+
+
+constexpr uint64_t ModReducer::one_form() const
+{
+     return is_montgomery() ? ( 0 - modulo_ ) % modulo_ : 1 % modulo_;
+}
+
+
+// t * 2^-64 mod m for t < m * 2^64, subtractive variant:
+// low halves of t and q*m cancel, so only high halves are needed
+constexpr uint64_t ModReducer::redc( wide_type t ) const
+{
+     uint64_t q = static_cast< uint64_t >( t ) * inv_;
+     uint64_t t_hi = static_cast< uint64_t >( t >> 64 );
+     uint64_t qm_hi = static_cast< uint64_t >( ( static_cast< wide_type >( q ) * modulo_ ) >> 64 );
+     return ( t_hi >= qm_hi ) ? t_hi - qm_hi : t_hi - qm_hi + modulo_;
+}
+
+
+// t mod m for any 128-bit t, quotient estimate is off by at most 3
+constexpr uint64_t ModReducer::barrett( wide_type t ) const
+{
+     const wide_type mask = ~uint64_t{ 0 };
+     wide_type t0 = t & mask, t1 = t >> 64;
+     wide_type m0 = mu_ & mask, m1 = mu_ >> 64;
+     wide_type p00 = t0 * m0, p01 = t0 * m1, p10 = t1 * m0, p11 = t1 * m1;
+     wide_type mid = ( p00 >> 64 ) + ( p01 & mask ) + ( p10 & mask );
+     wide_type q = p11 + ( p01 >> 64 ) + ( p10 >> 64 ) + ( mid >> 64 );
+     wide_type r = t - q * modulo_;
+     while ( r >= modulo_ )
+     {
+          r -= modulo_;
+     }
+     return static_cast< uint64_t >( r );
+}
+
+#endif // #ifndef MOD_REDUCER_H
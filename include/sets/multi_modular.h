@@ -0,0 +1,59 @@
+#ifndef MULTI_MODULAR_H
+#define MULTI_MODULAR_H
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+// exact integer or rational value kept as residues modulo several fixed
+// 62-bit primes (lanes), every lane is an independent word-sized ring;
+// the value is recovered with CRT or rational reconstruction, it is
+// exact while its magnitude (or numerator and denominator) stays below
+// the square root of half the product of the lane primes
+class MultiModular
+{
+public:
+     using integer_type = boost::multiprecision::cpp_int;
+     static constexpr size_t max_lanes = 16;
+
+     // zero lanes make a zero compatible with any lane count
+     MultiModular( size_t lanes = 0, int64_t value = 0 );
+     MultiModular( size_t lanes, const integer_type& value );
+     MultiModular( size_t lanes, const integer_type& num, const integer_type& den );
+
+     MultiModular& operator+= ( const MultiModular& other );
+     MultiModular& operator-= ( const MultiModular& other );
+     MultiModular& operator*= ( const MultiModular& other );
+     MultiModular& operator/= ( const MultiModular& other );
+     MultiModular operator- () const;  // unary minus
+     bool operator== ( const MultiModular& other ) const;
+     bool operator!= ( const MultiModular& other ) const;
+     explicit operator bool() const;
+
+     MultiModular inv() const;
+     size_t lanes() const;
+     uint64_t lane( size_t i ) const;
+     integer_type to_integer() const;                             // symmetric range
+     std::pair< integer_type, integer_type > to_rational() const;  // numerator, denominator > 0
+
+     static uint64_t prime( size_t i );
+     static integer_type modulus( size_t lanes );
+
+private:
+     std::vector< uint64_t > values_;
+
+     // returns false for a generic zero operand, throws on lane mismatch
+     bool check_lanes( const MultiModular& other );
+};
+
+
+MultiModular operator+ ( MultiModular a, const MultiModular& b );
+MultiModular operator- ( MultiModular a, const MultiModular& b );
+MultiModular operator* ( MultiModular a, const MultiModular& b );
+MultiModular operator/ ( MultiModular a, const MultiModular& b );
+MultiModular pow( const MultiModular& base, size_t exp );
+
+#endif // #ifndef MULTI_MODULAR_H
@@ -0,0 +1,17 @@
+#ifndef PRIMALITY_H
+#define PRIMALITY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// deterministic Miller-Rabin test for the whole 64-bit range,
+// the last few results of each thread are cached
+bool is_prime( uint64_t n );
+
+// prime factors with their exponents in increasing order: trial division
+// by small primes, then Pollard's rho in Brent's variant
+std::vector< std::pair< uint64_t, size_t > > factorize( uint64_t n );
+
+#endif // #ifndef PRIMALITY_H
@@ -0,0 +1,65 @@
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// rational number: numerator and denominator are kept in machine words
+// without allocation while they fit, and spill to a heap big rational
+// on overflow; gcd reduction is lazy, it runs only when an operation
+// would overflow and when parts are read
+class Rational
+{
+public:
+     using integer_type = boost::multiprecision::cpp_int;
+     using big_type = boost::multiprecision::cpp_rational;
+
+     Rational( int64_t num = 0, int64_t den = 1 );
+     Rational( const integer_type& num, const integer_type& den = 1 );
+     Rational( const Rational& other );
+     Rational( Rational&& other ) noexcept;
+
+     Rational& operator=  ( const Rational& other );
+     Rational& operator=  ( Rational&& other ) noexcept;
+     Rational& operator+= ( const Rational& other );
+     Rational& operator-= ( const Rational& other );
+     Rational& operator*= ( const Rational& other );
+     Rational& operator/= ( const Rational& other );
+     Rational operator- () const;  // unary minus
+     bool operator== ( const Rational& other ) const;
+     bool operator!= ( const Rational& other ) const;
+     bool operator<  ( const Rational& other ) const;
+     bool operator>  ( const Rational& other ) const;
+     bool operator<= ( const Rational& other ) const;
+     bool operator>= ( const Rational& other ) const;
+     explicit operator bool() const;
+
+     Rational inv() const;
+     integer_type numerator() const;    // of the reduced fraction
+     integer_type denominator() const;  // of the reduced fraction, > 0
+     bool is_small() const;             // true if no heap storage is used
+
+private:
+     int64_t num_;                      // small form, den_ > 0,
+     int64_t den_;                      // num_ != INT64_MIN
+     std::unique_ptr< big_type > big_;  // value if not null
+
+     void normalize();
+     bool add_small( int64_t num, int64_t den );
+     bool mul_small( int64_t num, int64_t den );
+     big_type to_big() const;
+     void set_big( big_type value );
+     int compare( const Rational& other ) const;
+};
+
+
+Rational operator+ ( Rational a, const Rational& b );
+Rational operator- ( Rational a, const Rational& b );
+Rational operator* ( Rational a, const Rational& b );
+Rational operator/ ( Rational a, const Rational& b );
+Rational pow( const Rational& base, size_t exp );
+
+#endif // #ifndef RATIONAL_H
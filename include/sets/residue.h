@@ -3,9 +3,17 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <vector>
+
+class ResidueRing;
 
 class Residue
 {
+     friend class ResidueRing;
+     friend Residue pow( const Residue& base, size_t exp );
+     friend std::vector< Residue > pow( const std::vector< Residue >& bases, size_t exp );
+     friend Residue multi_pow( const std::vector< Residue >& bases, const std::vector< size_t >& exps );
+
 public:
      Residue( uint64_t modulo = 0, int64_t value = 0 ) noexcept;
      Residue( const Residue& other ) noexcept;
@@ -40,5 +48,7 @@ Residue operator- ( Residue a, const Residue& b );
 Residue operator* ( Residue a, const Residue& b );
 Residue operator/ ( Residue a, const Residue& b );
 Residue pow( const Residue& base, size_t exp );
+std::vector< Residue > pow( const std::vector< Residue >& bases, size_t exp );      // each base to exp
+Residue multi_pow( const std::vector< Residue >& bases, const std::vector< size_t >& exps );  // prod bases[i]^exps[i]
 
 #endif // #ifndef RESIDUE_H
@@ -0,0 +1,232 @@
+#ifndef RESIDUE_ARRAY_H
+#define RESIDUE_ARRAY_H
+
+#include <sets/residue_ring.h>
+#include <sets/residue_kernels.h>
+
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+// contiguous array of residues over one ring, stores raw 32 or 64-bit
+// values, the ring must outlive the array
+template < typename Word >
+class ResidueArray
+{
+     static_assert( std::is_same< Word, uint32_t >::value || std::is_same< Word, uint64_t >::value,
+                    "residue words must be uint32_t or uint64_t" );
+
+public:
+     using word_type = Word;
+
+     explicit ResidueArray( const ResidueRing& ring, size_t size = 0 );
+     ResidueArray( const ResidueRing& ring, const std::vector< Residue >& values );
+
+     ResidueArray& operator+= ( const ResidueArray& other );
+     ResidueArray& operator-= ( const ResidueArray& other );
+     ResidueArray& operator*= ( const ResidueArray& other );  // element-wise
+     ResidueArray& operator*= ( const Residue& coeff );
+     ResidueArray& axpy( const Residue& coeff, const ResidueArray& x );  // *this += coeff * x
+     bool operator== ( const ResidueArray& other ) const;
+     bool operator!= ( const ResidueArray& other ) const;
+
+     Residue operator[] ( size_t i ) const;
+     Residue dot( const ResidueArray& other ) const;
+     void set( size_t i, const Residue& value );
+     void push_back( const Residue& value );
+     void resize( size_t size );
+     size_t size() const;
+     Word* data();
+     const Word* data() const;
+     const ResidueRing& ring() const;
+     std::vector< Residue > to_residues() const;
+
+private:
+     const ResidueRing* ring_;
+     std::vector< Word > values_;
+
+     void check_compatible( const ResidueArray& other ) const;
+};
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+template < typename Word >
+ResidueArray< Word >::ResidueArray( const ResidueRing& ring, size_t size ):
+     ring_{ &ring }, values_( size )
+{
+     if ( ring.get_modulo() - 1 > std::numeric_limits< Word >::max() )
+     {
+          throw std::runtime_error{ "modulo does not fit the word type" };
+     }
+}
+
+
+template < typename Word >
+ResidueArray< Word >::ResidueArray( const ResidueRing& ring, const std::vector< Residue >& values ):
+     ResidueArray{ ring }
+{
+     values_.reserve( values.size() );
+     for ( const auto& value : values )
+     {
+          push_back( value );
+     }
+}
+
+
+template < typename Word >
+ResidueArray< Word >& ResidueArray< Word >::operator+= ( const ResidueArray& other )
+{
+     check_compatible( other );
+     residue_add( *ring_, values_.data(), values_.data(), other.values_.data(), values_.size() );
+     return *this;
+}
+
+
+template < typename Word >
+ResidueArray< Word >& ResidueArray< Word >::operator-= ( const ResidueArray& other )
+{
+     check_compatible( other );
+     residue_sub( *ring_, values_.data(), values_.data(), other.values_.data(), values_.size() );
+     return *this;
+}
+
+
+template < typename Word >
+ResidueArray< Word >& ResidueArray< Word >::operator*= ( const ResidueArray& other )
+{
+     check_compatible( other );
+     residue_mul( *ring_, values_.data(), values_.data(), other.values_.data(), values_.size() );
+     return *this;
+}
+
+
+template < typename Word >
+ResidueArray< Word >& ResidueArray< Word >::operator*= ( const Residue& coeff )
+{
+     // coefficient goes to the internal form once, then every element
+     // needs a single reduction: a * c*R * R^-1 == a * c
+     const auto& reducer = ring_->reducer();
+     auto factor = reducer.to_form( ring_->value_of( coeff ) );
+     for ( auto& value : values_ )
+     {
+          value = reducer.mul_form( value, factor );
+     }
+     return *this;
+}
+
+
+template < typename Word >
+ResidueArray< Word >& ResidueArray< Word >::axpy( const Residue& coeff, const ResidueArray& x )
+{
+     check_compatible( x );
+     residue_axpy( *ring_, values_.data(), ring_->value_of( coeff ), x.values_.data(), values_.size() );
+     return *this;
+}
+
+
+template < typename Word >
+bool ResidueArray< Word >::operator== ( const ResidueArray& other ) const
+{
+     return *ring_ == *other.ring_ && values_ == other.values_;
+}
+
+
+template < typename Word >
+bool ResidueArray< Word >::operator!= ( const ResidueArray& other ) const
+{
+     return !( *this == other );
+}
+
+
+template < typename Word >
+Residue ResidueArray< Word >::operator[] ( size_t i ) const
+{
+     return ring_->element( values_[ i ] );
+}
+
+
+template < typename Word >
+Residue ResidueArray< Word >::dot( const ResidueArray& other ) const
+{
+     check_compatible( other );
+     return ring_->element( residue_dot( *ring_, values_.data(), other.values_.data(), values_.size() ) );
+}
+
+
+template < typename Word >
+void ResidueArray< Word >::set( size_t i, const Residue& value )
+{
+     values_[ i ] = static_cast< Word >( ring_->value_of( value ) );
+}
+
+
+template < typename Word >
+void ResidueArray< Word >::push_back( const Residue& value )
+{
+     values_.push_back( static_cast< Word >( ring_->value_of( value ) ) );
+}
+
+
+template < typename Word >
+void ResidueArray< Word >::resize( size_t size )
+{
+     values_.resize( size );
+}
+
+
+template < typename Word >
+size_t ResidueArray< Word >::size() const
+{
+     return values_.size();
+}
+
+
+template < typename Word >
+Word* ResidueArray< Word >::data()
+{
+     return values_.data();
+}
+
+
+template < typename Word >
+const Word* ResidueArray< Word >::data() const
+{
+     return values_.data();
+}
+
+
+template < typename Word >
+const ResidueRing& ResidueArray< Word >::ring() const
+{
+     return *ring_;
+}
+
+
+template < typename Word >
+std::vector< Residue > ResidueArray< Word >::to_residues() const
+{
+     std::vector< Residue > ret;
+     ret.reserve( values_.size() );
+     for ( auto value : values_ )
+     {
+          ret.push_back( ring_->element( value ) );
+     }
+     return ret;
+}
+
+
+template < typename Word >
+void ResidueArray< Word >::check_compatible( const ResidueArray& other ) const
+{
+     if ( *ring_ != *other.ring_ )
+     {
+          throw std::runtime_error{ "different modulo values" };
+     }
+     if ( values_.size() != other.values_.size() )
+     {
+          throw std::runtime_error{ "different array sizes" };
+     }
+}
+
+#endif // #ifndef RESIDUE_ARRAY_H
@@ -0,0 +1,29 @@
+#ifndef RESIDUE_KERNELS_H
+#define RESIDUE_KERNELS_H
+
+#include <sets/residue_ring.h>
+
+#include <cstdint>
+#include <cstddef>
+
+// batch kernels over raw residue values of one ring, every value must be
+// in [0, modulo), dst may alias operands; 32-bit arrays over odd moduli
+// below 2^31 run AVX-512 or AVX2 code when the CPU has it
+
+void residue_add( const ResidueRing& ring, uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n );
+void residue_add( const ResidueRing& ring, uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n );
+
+void residue_sub( const ResidueRing& ring, uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n );
+void residue_sub( const ResidueRing& ring, uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n );
+
+void residue_mul( const ResidueRing& ring, uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n );
+void residue_mul( const ResidueRing& ring, uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n );
+
+// y += c * x, pass ring.neg( c ) for row operations y -= c * x
+void residue_axpy( const ResidueRing& ring, uint32_t* y, uint64_t c, const uint32_t* x, size_t n );
+void residue_axpy( const ResidueRing& ring, uint64_t* y, uint64_t c, const uint64_t* x, size_t n );
+
+uint64_t residue_dot( const ResidueRing& ring, const uint32_t* a, const uint32_t* b, size_t n );
+uint64_t residue_dot( const ResidueRing& ring, const uint64_t* a, const uint64_t* b, size_t n );
+
+#endif // #ifndef RESIDUE_KERNELS_H
@@ -0,0 +1,36 @@
+#ifndef RESIDUE_RING_H
+#define RESIDUE_RING_H
+
+#include <sets/mod_reducer.h>
+#include <sets/residue.h>
+
+#include <cstdint>
+#include <cstddef>
+
+// ring of residues modulo a fixed number: holds the modulo and its
+// reduction constants once, elements are raw values in [0, modulo)
+class ResidueRing
+{
+public:
+     explicit ResidueRing( uint64_t modulo );
+
+     bool operator== ( const ResidueRing& other ) const;
+     bool operator!= ( const ResidueRing& other ) const;
+
+     uint64_t reduce( int64_t value ) const;
+     uint64_t add( uint64_t a, uint64_t b ) const;
+     uint64_t sub( uint64_t a, uint64_t b ) const;
+     uint64_t neg( uint64_t a ) const;
+     uint64_t mul( uint64_t a, uint64_t b ) const;
+     uint64_t inv( uint64_t a ) const;
+
+     Residue element( uint64_t value ) const;
+     uint64_t value_of( const Residue& elem ) const;    // checks elem's modulo
+     uint64_t get_modulo() const;
+     const ModReducer& reducer() const;
+
+private:
+     ModReducer reducer_;
+};
+
+#endif // #ifndef RESIDUE_RING_H
@@ -0,0 +1,291 @@
+#ifndef STATIC_RESIDUE_H
+#define STATIC_RESIDUE_H
+
+#include <sets/mod_reducer.h>
+#include <sets/residue.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+// residue with a compile-time modulo: stores only the value, needs
+// no modulo checks, small moduli reduce with multiply-shift sequences
+template < uint64_t Modulo >
+class StaticResidue
+{
+     static_assert( Modulo > 1, "modulo must be greater than 1" );
+
+public:
+     constexpr StaticResidue( int64_t value = 0 ) noexcept;
+
+     constexpr StaticResidue& operator+= ( const StaticResidue& other );
+     constexpr StaticResidue& operator-= ( const StaticResidue& other );
+     constexpr StaticResidue& operator*= ( const StaticResidue& other );
+     constexpr StaticResidue& operator/= ( const StaticResidue& other );
+     constexpr StaticResidue operator- () const;  // unary minus
+     constexpr bool operator== ( const StaticResidue& other ) const;
+     constexpr bool operator!= ( const StaticResidue& other ) const;
+     constexpr bool operator<  ( const StaticResidue& other ) const;
+     constexpr bool operator>  ( const StaticResidue& other ) const;
+     constexpr bool operator<= ( const StaticResidue& other ) const;
+     constexpr bool operator>= ( const StaticResidue& other ) const;
+     constexpr explicit operator bool() const;
+
+     constexpr StaticResidue inv() const;
+     static constexpr uint64_t get_modulo();
+     constexpr uint64_t get_value() const;
+     static bool is_field();
+
+private:
+     static constexpr ModReducer reducer_{ Modulo };
+
+     uint64_t value_;
+
+     static constexpr uint64_t mul( uint64_t a, uint64_t b );
+};
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator+ ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b );
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator- ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b );
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator* ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b );
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator/ ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b );
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > pow( StaticResidue< Modulo > base, size_t exp );
+
+//-----------------------------------------IMPLEMENTATION------------------------------------------
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo >::StaticResidue( int64_t value ) noexcept:
+     value_{ 0 }
+{
+     if ( value >= 0 )
+     {
+          value_ = static_cast< uint64_t >( value ) % Modulo;
+     }
+     else
+     {
+          value_ = reducer_.neg( ( -static_cast< uint64_t >( value ) ) % Modulo );
+     }
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo >& StaticResidue< Modulo >::operator+= ( const StaticResidue& other )
+{
+     value_ = reducer_.add( value_, other.value_ );
+     return *this;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo >& StaticResidue< Modulo >::operator-= ( const StaticResidue& other )
+{
+     value_ = reducer_.sub( value_, other.value_ );
+     return *this;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo >& StaticResidue< Modulo >::operator*= ( const StaticResidue& other )
+{
+     value_ = mul( value_, other.value_ );
+     return *this;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo >& StaticResidue< Modulo >::operator/= ( const StaticResidue& other )
+{
+     if ( !( *this ) )
+     {
+          return *this;
+     }
+     value_ = mul( value_, other.inv().value_ );
+     return *this;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > StaticResidue< Modulo >::operator- () const
+{
+     StaticResidue ret;
+     ret.value_ = reducer_.neg( value_ );
+     return ret;
+}
+
+
+template < uint64_t Modulo >
+constexpr bool StaticResidue< Modulo >::operator== ( const StaticResidue& other ) const
+{
+     return value_ == other.value_;
+}
+
+
+template < uint64_t Modulo >
+constexpr bool StaticResidue< Modulo >::operator!= ( const StaticResidue& other ) const
+{
+     return value_ != other.value_;
+}
+
+
+template < uint64_t Modulo >
+constexpr bool StaticResidue< Modulo >::operator< ( const StaticResidue& other ) const
+{
+     return value_ < other.value_;
+}
+
+
+template < uint64_t Modulo >
+constexpr bool StaticResidue< Modulo >::operator> ( const StaticResidue& other ) const
+{
+     return value_ > other.value_;
+}
+
+
+template < uint64_t Modulo >
+constexpr bool StaticResidue< Modulo >::operator<= ( const StaticResidue& other ) const
+{
+     return value_ <= other.value_;
+}
+
+
+template < uint64_t Modulo >
+constexpr bool StaticResidue< Modulo >::operator>= ( const StaticResidue& other ) const
+{
+     return value_ >= other.value_;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo >::operator bool() const
+{
+     return value_ != 0;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > StaticResidue< Modulo >::inv() const
+{
+     if ( !( *this ) )
+     {
+          throw std::runtime_error{ "division by zero" };
+     }
+     // extended euclidean algorithm
+     // |t| <= Modulo, signed 128 bits keep the sign for any 64-bit modulo
+     __int128 t    = 0;
+     __int128 newt = 1;
+     uint64_t r = Modulo, newr = value_;
+     while ( newr != 0 )
+     {
+          auto quotient = r / newr;
+          auto tmp = t - static_cast< __int128 >( quotient ) * newt;
+          t    = newt;
+          newt = tmp;
+          auto rem = r - quotient * newr;
+          r    = newr;
+          newr = rem;
+     }
+     if ( r > 1 )
+     {
+          throw std::runtime_error{ "not invertible element" };
+     }
+     if ( t < 0 )
+     {
+          t += Modulo;
+     }
+     StaticResidue ret;
+     ret.value_ = static_cast< uint64_t >( t ) % Modulo;
+     return ret;
+}
+
+
+template < uint64_t Modulo >
+constexpr uint64_t StaticResidue< Modulo >::get_modulo()
+{
+     return Modulo;
+}
+
+
+template < uint64_t Modulo >
+constexpr uint64_t StaticResidue< Modulo >::get_value() const
+{
+     return value_;
+}
+
+
+template < uint64_t Modulo >
+bool StaticResidue< Modulo >::is_field()
+{
+     return Residue{ Modulo }.is_field();
+}
+
+
+// products of 32-bit moduli fit in 64 bits, there the compiler
+// turns % by a constant into multiply-shift on its own
+template < uint64_t Modulo >
+constexpr uint64_t StaticResidue< Modulo >::mul( uint64_t a, uint64_t b )
+{
+     if constexpr ( Modulo <= ( uint64_t{ 1 } << 32 ) )
+     {
+          return ( a * b ) % Modulo;
+     }
+     else
+     {
+          return reducer_.mul( a, b );
+     }
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator+ ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b )
+{
+     return a += b;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator- ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b )
+{
+     return a -= b;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator* ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b )
+{
+     return a *= b;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > operator/ ( StaticResidue< Modulo > a, const StaticResidue< Modulo >& b )
+{
+     return a /= b;
+}
+
+
+template < uint64_t Modulo >
+constexpr StaticResidue< Modulo > pow( StaticResidue< Modulo > base, size_t exp )
+{
+     StaticResidue< Modulo > result{ 1 };
+     while ( exp )
+     {
+          if ( exp & 1 )
+          {
+               result *= base;
+          }
+          base *= base;
+          exp >>= 1;
+     }
+     return result;
+}
+
+#endif // #ifndef STATIC_RESIDUE_H
@@ -0,0 +1,190 @@
+#include <matrix/matrix_kernels.h>
+#include <sets/mod_reducer.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+using wide_type = unsigned __int128;
+
+
+// tiles: block_k rows of b by block_j columns stay in cache while
+// every row of a passes over them
+const size_t block_k = 64;
+const size_t block_j = 256;
+
+
+// a^-1 mod m for gcd( a, m ) = 1
+uint64_t inv_mod( uint64_t a, uint64_t m )
+{
+     __int128 r0 = m, r1 = a % m, t0 = 0, t1 = 1;
+     while ( r1 != 0 )
+     {
+          __int128 q = r0 / r1, tmp = r0 - q * r1;
+          r0 = r1;
+          r1 = tmp;
+          tmp = t0 - q * t1;
+          t0 = t1;
+          t1 = tmp;
+     }
+     if ( r0 != 1 )
+     {
+          throw std::runtime_error{ "not invertible element" };
+     }
+     return static_cast< uint64_t >( t0 < 0 ? t0 + m : t0 );
+}
+
+
+// Gauss-Jordan elimination on raw values, Field supplies inv( a ),
+// scale( a, f ) = a * f and sub_mul( a, factor( f ), b ) = a - f * b
+template < typename Field >
+std::vector< size_t > eliminate( uint64_t* a, size_t rows, size_t cols, const Field& field )
+{
+     std::vector< size_t > pivots;
+     for ( size_t col = 0, r = 0; col < cols && r < rows; col++ )
+     {
+          size_t s = r;
+          while ( s < rows && !a[ s * cols + col ] )
+          {
+               s++;
+          }
+          if ( s == rows )
+          {
+               continue;
+          }
+          uint64_t* pivot = a + r * cols;
+          if ( s != r )
+          {
+               std::swap_ranges( pivot + col, pivot + cols, a + s * cols + col );
+          }
+          uint64_t scale = field.inv( pivot[ col ] );
+          for ( size_t j = col; j < cols; j++ )
+          {
+               pivot[ j ] = field.scale( pivot[ j ], scale );
+          }
+          for ( size_t i = 0; i < rows; i++ )
+          {
+               uint64_t* row = a + i * cols;
+               uint64_t f = row[ col ];
+               if ( i == r || !f )
+               {
+                    continue;
+               }
+               auto factor = field.factor( f );
+               for ( size_t j = col; j < cols; j++ )
+               {
+                    row[ j ] = field.sub_mul( row[ j ], factor, pivot[ j ] );
+               }
+          }
+          pivots.push_back( col );
+          r++;
+     }
+     return pivots;
+}
+
+
+// the row factor is kept in Montgomery form, negated, so a row
+// update is one multiplication and one addition per entry
+struct ModField
+{
+     ModReducer red;
+
+     uint64_t inv( uint64_t a ) const { return inv_mod( a, red.get_modulo() ); }
+     uint64_t scale( uint64_t a, uint64_t f ) const { return red.mul( a, f ); }
+     uint64_t factor( uint64_t f ) const { return red.to_form( red.neg( f ) ); }
+     uint64_t sub_mul( uint64_t a, uint64_t factor, uint64_t b ) const { return red.add( a, red.mul_form( factor, b ) ); }
+};
+
+
+struct Gf2Field
+{
+     const Gf2Reducer& red;
+
+     uint64_t inv( uint64_t a ) const { return red.inv( a ); }
+     uint64_t scale( uint64_t a, uint64_t f ) const { return red.mul( a, f ); }
+     uint64_t factor( uint64_t f ) const { return f; }
+     uint64_t sub_mul( uint64_t a, uint64_t factor, uint64_t b ) const { return a ^ red.mul( factor, b ); }
+};
+
+} // namespace
+
+
+void matrix_mul( uint64_t* c, const uint64_t* a, const uint64_t* b,
+                 size_t n, size_t m, size_t p, uint64_t modulo )
+{
+     ModReducer red{ modulo };
+     std::fill( c, c + n * p, 0 );
+     for ( size_t kk = 0; kk < m; kk += block_k )
+     {
+          size_t k_end = std::min( m, kk + block_k );
+          for ( size_t jj = 0; jj < p; jj += block_j )
+          {
+               size_t j_end = std::min( p, jj + block_j );
+               for ( size_t i = 0; i < n; i++ )
+               {
+                    uint64_t* c_row = c + i * p;
+                    for ( size_t k = kk; k < k_end; k++ )
+                    {
+                         uint64_t a_ik = a[ i * m + k ];
+                         if ( !a_ik )
+                         {
+                              continue;
+                         }
+                         uint64_t f = red.to_form( a_ik );
+                         const uint64_t* b_row = b + k * p;
+                         for ( size_t j = jj; j < j_end; j++ )
+                         {
+                              c_row[ j ] = red.add( c_row[ j ], red.mul_form( f, b_row[ j ] ) );
+                         }
+                    }
+               }
+          }
+     }
+}
+
+
+// products are summed unreduced, one reduction per entry of c
+void matrix_mul( uint64_t* c, const uint64_t* a, const uint64_t* b,
+                 size_t n, size_t m, size_t p, const Gf2Reducer& field )
+{
+     std::vector< wide_type > acc( block_j );
+     for ( size_t jj = 0; jj < p; jj += block_j )
+     {
+          size_t width = std::min( p - jj, block_j );
+          for ( size_t i = 0; i < n; i++ )
+          {
+               std::fill( acc.begin(), acc.end(), 0 );
+               for ( size_t k = 0; k < m; k++ )
+               {
+                    uint64_t a_ik = a[ i * m + k ];
+                    if ( !a_ik )
+                    {
+                         continue;
+                    }
+                    const uint64_t* b_row = b + k * p + jj;
+                    for ( size_t j = 0; j < width; j++ )
+                    {
+                         acc[ j ] ^= clmul( a_ik, b_row[ j ] );
+                    }
+               }
+               for ( size_t j = 0; j < width; j++ )
+               {
+                    c[ i * p + jj + j ] = field.reduce( acc[ j ] );
+               }
+          }
+     }
+}
+
+
+std::vector< size_t > matrix_eliminate( uint64_t* a, size_t rows, size_t cols, uint64_t modulo )
+{
+     return eliminate( a, rows, cols, ModField{ ModReducer{ modulo } } );
+}
+
+
+std::vector< size_t > matrix_eliminate( uint64_t* a, size_t rows, size_t cols, const Gf2Reducer& field )
+{
+     return eliminate( a, rows, cols, Gf2Field{ field } );
+}
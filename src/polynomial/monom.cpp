@@ -1,26 +1,61 @@
 #include <polynomial/monom.h>
 
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 
-Monom::Monom( const std::map< std::string, size_t >& vars ) noexcept
+namespace
+{
+
+using exponent_type = Monom::exponent_type;
+
+
+exponent_type checked( size_t deg )
+{
+     if ( deg > std::numeric_limits< exponent_type >::max() )
+     {
+          throw std::runtime_error{ "monomial exponent overflow" };
+     }
+     return static_cast< exponent_type >( deg );
+}
+
+} // namespace
+
+
+Monom::Monom( const std::map< std::string, size_t >& vars ):
+     Monom{ PolyRing::default_ring(), vars } {}
+
+
+Monom::Monom( const PolyRing& ring, const std::map< std::string, size_t >& vars ):
+     ring_{ &ring }, divmask_{ 0 }, deg_{ 0 }
 {
      for ( const auto& var : vars )
      {
           if ( var.second )
           {
-               vars_.insert( var );
+               set_deg( var.first, var.second );
           }
      }
 }
 
 
+Monom::Monom( const PolyRing& ring, std::vector< exponent_type > exps ):
+     ring_{ &ring }, exps_{ std::move( exps ) }, divmask_{ 0 }, deg_{ 0 }
+{
+     trim();
+}
+
+
 Monom::Monom( const Monom& other ) noexcept:
-     vars_{ other.vars_ } {}
+     ring_{ other.ring_ }, exps_{ other.exps_ }, divmask_{ other.divmask_ }, deg_{ other.deg_ } {}
 
 
-Monom::Monom( Monom&& other ) noexcept
+Monom::Monom( Monom&& other ) noexcept:
+     ring_{ other.ring_ }, divmask_{ other.divmask_ }, deg_{ other.deg_ }
 {
-     std::swap( vars_, other.vars_ );
+     std::swap( exps_, other.exps_ );
+     other.divmask_ = 0;
+     other.deg_ = 0;
 }
 
 
@@ -28,7 +63,10 @@ Monom& Monom::operator= ( const Monom& other ) noexcept
 {
      if ( &other != this )
      {
-          vars_ = other.vars_;
+          ring_ = other.ring_;
+          exps_ = other.exps_;
+          divmask_ = other.divmask_;
+          deg_ = other.deg_;
      }
      return *this;
 }
@@ -38,8 +76,13 @@ Monom& Monom::operator= ( Monom&& other ) noexcept
 {
      if ( &other != this )
      {
-          vars_ = {};
-          std::swap( vars_, other.vars_ );
+          ring_ = other.ring_;
+          exps_ = {};
+          std::swap( exps_, other.exps_ );
+          divmask_ = other.divmask_;
+          deg_ = other.deg_;
+          other.divmask_ = 0;
+          other.deg_ = 0;
      }
      return *this;
 }
@@ -47,48 +90,62 @@ Monom& Monom::operator= ( Monom&& other ) noexcept
 
 Monom& Monom::operator*= ( const Monom& other )
 {
-     for ( const auto& kv_pair : other.vars_ )
+     // overflow is checked before anything changes, so a throw leaves
+     // the exponents and the cached fields as they were
+     for ( size_t i = 0; i < std::min( exps_.size(), other.exps_.size() ); i++ )
      {
-          vars_[ kv_pair.first ] += kv_pair.second;
+          checked( size_t{ exps_[ i ] } + other.exps_[ i ] );
      }
+     join_ring( other );
+     if ( exps_.size() < other.exps_.size() )
+     {
+          exps_.resize( other.exps_.size(), 0 );
+     }
+     for ( size_t i = 0; i < other.exps_.size(); i++ )
+     {
+          exps_[ i ] += other.exps_[ i ];
+     }
+     divmask_ |= other.divmask_;
+     deg_ += other.deg_;
      return *this;
 }
 
 
 Monom& Monom::operator/= ( const Monom& other )
 {
-     for ( const auto& kv_pair : other.vars_ )
+     if ( !is_divisible( other ) )
      {
-          auto found = vars_.find( kv_pair.first );
-          if ( found == vars_.end() || found->second < kv_pair.second )
-          {
-               throw std::runtime_error{ "indivisible monomials" };
-          }
-          found->second -= kv_pair.second;
-          if ( found->second == 0 )
-          {
-               vars_.erase( found );
-          }
+          throw std::runtime_error{ "indivisible monomials" };
      }
+     for ( size_t i = 0; i < other.exps_.size(); i++ )
+     {
+          exps_[ i ] -= other.exps_[ i ];
+     }
+     trim();
      return *this;
 }
 
 
 bool Monom::operator== ( const Monom& other ) const
 {
-     return vars_ == other.vars_;
+     return exps_ == other.exps_ && ( exps_.empty() || ring_ == other.ring_ );
 }
 
 
 bool Monom::operator!= ( const Monom& other ) const
 {
-     return vars_ != other.vars_;
+     return !( *this == other );
 }
 
 
 void Monom::remove_var( const std::string& var )
 {
-     vars_.erase( var );
+     size_t index = ring_->find( var );
+     if ( index < exps_.size() )
+     {
+          exps_[ index ] = 0;
+          trim();
+     }
 }
 
 
@@ -96,49 +153,58 @@ void Monom::set_deg( const std::string& var, size_t deg )
 {
      if ( deg == 0 )
      {
-          vars_.erase( var );
+          remove_var( var );
+          return;
      }
-     else
+     exponent_type exp = checked( deg );
+     size_t index = ring_->intern( var );
+     if ( index >= exps_.size() )
      {
-          vars_[ var ] = deg;
+          exps_.resize( index + 1, 0 );
      }
+     deg_ = deg_ - exps_[ index ] + exp;
+     exps_[ index ] = exp;
+     divmask_ |= uint64_t{ 1 } << ( index % 64 );
 }
 
 
 size_t Monom::var_deg( const std::string& var ) const
 {
-     auto found = vars_.find( var );
-     if ( found == vars_.cend() )
-     {
-          return 0;
-     }
-     return found->second;
+     return var_deg( ring_->find( var ) );
+}
+
+
+size_t Monom::var_deg( size_t index ) const
+{
+     return ( index < exps_.size() ) ? exps_[ index ] : 0;
 }
 
 
 size_t Monom::full_deg() const
 {
-     size_t full = 0;
-     for ( const auto& kv_pair : vars_ )
-     {
-          full += kv_pair.second;
-     }
-     return full;
+     return deg_;
 }
 
 
 size_t Monom::var_count() const
 {
-     return vars_.size();
+     return exps_.size() - std::count( exps_.begin(), exps_.end(), 0 );
 }
 
 
 bool Monom::is_divisible( const Monom& other ) const
 {
-     for ( const auto& kv_pair : other.vars_ )
+     if ( other.exps_.empty() )
+     {
+          return true;
+     }
+     if ( ( other.divmask_ & ~divmask_ ) || other.exps_.size() > exps_.size() || ring_ != other.ring_ )
+     {
+          return false;
+     }
+     for ( size_t i = 0; i < other.exps_.size(); i++ )
      {
-          auto found = vars_.find( kv_pair.first );
-          if ( found == vars_.cend() || found->second < kv_pair.second )
+          if ( exps_[ i ] < other.exps_[ i ] )
           {
                return false;
           }
@@ -147,9 +213,83 @@ bool Monom::is_divisible( const Monom& other ) const
 }
 
 
-const std::map< std::string, size_t >& Monom::get_vars() const
+std::map< std::string, size_t > Monom::get_vars() const
 {
-     return vars_;
+     std::map< std::string, size_t > vars;
+     for ( size_t i = 0; i < exps_.size(); i++ )
+     {
+          if ( exps_[ i ] )
+          {
+               vars.emplace( ring_->name( i ), exps_[ i ] );
+          }
+     }
+     return vars;
+}
+
+
+const PolyRing& Monom::ring() const
+{
+     return *ring_;
+}
+
+
+const std::vector< Monom::exponent_type >& Monom::exps() const
+{
+     return exps_;
+}
+
+
+uint64_t Monom::divmask() const
+{
+     return divmask_;
+}
+
+
+// equal monomials have equal exponent vectors, whatever their rings
+size_t Monom::hash() const
+{
+     uint64_t h = 0x9e3779b97f4a7c15ULL;
+     for ( auto exp : exps_ )
+     {
+          h = ( h ^ exp ) * 0x100000001b3ULL;
+          h ^= h >> 29;
+     }
+     return static_cast< size_t >( h );
+}
+
+
+// drops trailing zeroes and rebuilds the divmask and the degree
+void Monom::trim()
+{
+     while ( !exps_.empty() && exps_.back() == 0 )
+     {
+          exps_.pop_back();
+     }
+     divmask_ = 0;
+     deg_ = 0;
+     for ( size_t i = 0; i < exps_.size(); i++ )
+     {
+          if ( exps_[ i ] )
+          {
+               divmask_ |= uint64_t{ 1 } << ( i % 64 );
+               deg_ += exps_[ i ];
+          }
+     }
+}
+
+
+// the monomial 1 takes the ring of the other operand
+void Monom::join_ring( const Monom& other )
+{
+     if ( other.exps_.empty() || ring_ == other.ring_ )
+     {
+          return;
+     }
+     if ( !exps_.empty() )
+     {
+          throw std::runtime_error{ "monomials from different rings" };
+     }
+     ring_ = other.ring_;
 }
 
 
@@ -159,26 +299,31 @@ Monom operator/ ( Monom lhs, const Monom& rhs ) { return lhs /= rhs; }
 
 Monom pow( const Monom base, size_t exp )
 {
-     std::map< std::string, size_t > vars = base.get_vars();
-     for ( auto& kv_pair : vars )
+     auto exps = base.exps();
+     for ( auto& e : exps )
      {
-          kv_pair.second *= exp;
+          if ( exp > std::numeric_limits< exponent_type >::max() )
+          {
+               throw std::runtime_error{ "monomial exponent overflow" };
+          }
+          e = checked( size_t{ e } * exp );
      }
-     return Monom{ vars };
+     return Monom{ base.ring(), exps };
 }
 
 
 Monom lcm(const Monom& a, const Monom& b)
 {
-     std::map< std::string, size_t > vars;
-     const auto& vars_a = a.get_vars(), vars_b = b.get_vars();
-     for ( const auto& var : vars_a )
+     const auto& exps_a = a.exps();
+     const auto& exps_b = b.exps();
+     if ( !exps_a.empty() && !exps_b.empty() && &a.ring() != &b.ring() )
      {
-          vars[ var.first ] = std::max( var.second, b.var_deg( var.first ) );
+          throw std::runtime_error{ "monomials from different rings" };
      }
-     for ( const auto& var : vars_b )
+     std::vector< exponent_type > exps( std::max( exps_a.size(), exps_b.size() ), 0 );
+     for ( size_t i = 0; i < exps.size(); i++ )
      {
-          vars[ var.first ] = std::max( var.second, a.var_deg( var.first ) );
+          exps[ i ] = static_cast< exponent_type >( std::max( a.var_deg( i ), b.var_deg( i ) ) );
      }
-     return Monom{ vars };
+     return Monom{ exps_a.empty() ? b.ring() : a.ring(), exps };
 }
@@ -1,65 +1,86 @@
 #include <polynomial/monom_compare.h>
 #include <polynomial/monom.h>
 
-bool LexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
+#include <stdexcept>
+
+namespace
+{
+
+int sign( size_t lhs, size_t rhs )
 {
-     auto iter_l = lhs.get_vars().cbegin();
-     auto iter_r = rhs.get_vars().cbegin();
-     // monom is greater if its first variable is less
-	while ( iter_l != lhs.get_vars().cend() && iter_r != rhs.get_vars().cend() )
+     return ( lhs > rhs ) - ( lhs < rhs );
+}
+
+
+size_t block_deg( const Monom& monom, const uint32_t* first, const uint32_t* last )
+{
+     size_t deg = 0;
+     for ( ; first != last; ++first )
      {
-		int cmp = ( iter_l->first ).compare( iter_r->first );
-		if ( cmp != 0 )
-          {
-			return cmp < 0;
-          }
-		if ( iter_l->second != iter_r->second )    // degree comprasion
-          {
-               return iter_l->second > iter_r->second;
-          }
-		++iter_l;
-          ++iter_r;
-	}
-     if ( iter_l != lhs.get_vars().cend() && iter_r == rhs.get_vars().cend() )
+          deg += monom.var_deg( *first );
+     }
+     return deg;
+}
+
+} // namespace
+
+
+const std::vector< uint32_t >& variable_order( const Monom& lhs, const Monom& rhs )
+{
+     if ( lhs.exps().empty() )
      {
-          return true;
+          return rhs.ring().order();
      }
-     if ( iter_l == lhs.get_vars().cend() && iter_r != rhs.get_vars().cend() )
+     if ( !rhs.exps().empty() && &lhs.ring() != &rhs.ring() )
      {
-          return false;
+          throw std::runtime_error{ "monomials from different rings" };
      }
-	return false; // equal
+     return lhs.ring().order();
 }
 
 
-bool InvlexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
+bool LexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
 {
-     auto iter_l = lhs.get_vars().crbegin();
-     auto iter_r = rhs.get_vars().crbegin();
-     // monom is greater if its last variable is greater
-     while ( iter_l != lhs.get_vars().crend() && iter_r != rhs.get_vars().crend() )
+     const auto& order = variable_order( lhs, rhs );
+     return compare( lhs, rhs, order.data(), order.data() + order.size() ) > 0;
+}
+
+
+int LexGreater::compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last )
+{
+     // monom is greater if it has a higher degree in the first variable they differ in
+     for ( ; first != last; ++first )
      {
-          int cmp = ( iter_l->first ).compare( iter_r->first );
-          if ( cmp != 0 )
-          {
-               return cmp > 0;
-          }
-          if ( iter_l->second != iter_r->second )    // degree comprasion
+          size_t deg_l = lhs.var_deg( *first ), deg_r = rhs.var_deg( *first );
+          if ( deg_l != deg_r )
           {
-               return iter_l->second > iter_r->second;
+               return sign( deg_l, deg_r );
           }
-          ++iter_l;
-          ++iter_r;
      }
-     if ( iter_l != lhs.get_vars().crend() && iter_r == rhs.get_vars().crend() )
-     {
-          return true;
-     }
-     if ( iter_l == lhs.get_vars().crend() && iter_r != rhs.get_vars().crend() )
+     return 0; // equal
+}
+
+
+bool InvlexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
+{
+     const auto& order = variable_order( lhs, rhs );
+     return compare( lhs, rhs, order.data(), order.data() + order.size() ) > 0;
+}
+
+
+int InvlexGreater::compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last )
+{
+     // the same from the last variable
+     while ( last != first )
      {
-          return false;
+          --last;
+          size_t deg_l = lhs.var_deg( *last ), deg_r = rhs.var_deg( *last );
+          if ( deg_l != deg_r )
+          {
+               return sign( deg_l, deg_r );
+          }
      }
-     return false; // equal
+     return 0; // equal
 }
 
 
@@ -74,6 +95,13 @@ bool GrlexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
 }
 
 
+int GrlexGreater::compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last )
+{
+     int result = sign( block_deg( lhs, first, last ), block_deg( rhs, first, last ) );
+     return result ? result : LexGreater::compare( lhs, rhs, first, last );
+}
+
+
 bool GrevlexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
 {
      size_t deg_l = lhs.full_deg(), deg_r = rhs.full_deg();
@@ -85,7 +113,20 @@ bool GrevlexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
 }
 
 
+int GrevlexGreater::compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last )
+{
+     int result = sign( block_deg( lhs, first, last ), block_deg( rhs, first, last ) );
+     return result ? result : RinvlexGreater::compare( lhs, rhs, first, last );
+}
+
+
 bool RinvlexGreater::operator() ( const Monom& lhs, const Monom& rhs ) const
 {
      return InvlexGreater{}( rhs, lhs ); // arguments swapped
 }
+
+
+int RinvlexGreater::compare( const Monom& lhs, const Monom& rhs, const uint32_t* first, const uint32_t* last )
+{
+     return InvlexGreater::compare( rhs, lhs, first, last );
+}
@@ -0,0 +1,293 @@
+#include <polynomial/ntt.h>
+#include <sets/mod_reducer.h>
+#include <sets/primality.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+
+// twiddles for transforms up to size(): the level with half length h uses
+// w^j for the primitive 2h-th root w, stored contiguously at [ h, 2h ),
+// so the butterflies read them sequentially; the table does not depend on
+// the transform size; shoup[ j ] = floor( twiddles[ j ] * 2^64 / modulo )
+struct NttTwiddles
+{
+     std::vector< uint64_t > forward, forward_shoup;
+     std::vector< uint64_t > inverse, inverse_shoup;
+
+     size_t size() const { return forward.size(); }
+};
+
+
+// prime modulo = c * 2^max_log + 1 and a root of unity of order 2^max_log
+struct NttPrime
+{
+     size_t max_log = 0;
+     uint64_t root = 0;
+     std::shared_ptr< const NttTwiddles > twiddles;   // replaced when a larger one is needed
+};
+
+
+uint64_t pow_mod( const ModReducer& red, uint64_t base, uint64_t exp )
+{
+     uint64_t result = red.one_form(), square = red.to_form( base );
+     while ( exp )
+     {
+          if ( exp & 1 )
+          {
+               result = red.mul_form( result, square );
+          }
+          square = red.mul_form( square, square );
+          exp >>= 1;
+     }
+     return red.from_form( result );
+}
+
+
+// power of 2 dividing modulo - 1, modulo > 1
+size_t two_adicity( uint64_t modulo )
+{
+     size_t log = 0;
+     for ( uint64_t rest = modulo - 1; !( rest & 1 ); rest >>= 1 )
+     {
+          log++;
+     }
+     return log;
+}
+
+
+NttPrime find_root( uint64_t modulo )
+{
+     NttPrime prime;
+     prime.max_log = two_adicity( modulo );
+     uint64_t odd = ( modulo - 1 ) >> prime.max_log;
+     std::vector< uint64_t > factors{ 2 };      // prime factors of modulo - 1
+     for ( const auto& factor : factorize( odd ) )
+     {
+          factors.push_back( factor.first );
+     }
+     ModReducer red{ modulo };
+     for ( uint64_t g = 2; ; g++ )   // smallest generator of the multiplicative group
+     {
+          bool generator = true;
+          for ( size_t i = 0; i < factors.size() && generator; i++ )
+          {
+               generator = pow_mod( red, g, ( modulo - 1 ) / factors[ i ] ) != 1;
+          }
+          if ( generator )
+          {
+               prime.root = pow_mod( red, g, odd );
+               return prime;
+          }
+     }
+}
+
+
+std::mutex& cache_mutex()
+{
+     static std::mutex mutex;
+     return mutex;
+}
+
+
+NttPrime make_prime( uint64_t modulo )
+{
+     bool usable = ( modulo & 1 ) && modulo > 2 && modulo < ( uint64_t{ 1 } << 62 ) && is_prime( modulo );
+     return usable ? find_root( modulo ) : NttPrime{};
+}
+
+
+std::map< uint64_t, NttPrime >& prime_cache()
+{
+     static std::map< uint64_t, NttPrime > cache;
+     return cache;
+}
+
+
+// cached per modulo, max_log == 0 marks an unsupported one,
+// the caller holds cache_mutex()
+NttPrime& ntt_prime_locked( uint64_t modulo )
+{
+     auto& cache = prime_cache();
+     auto found = cache.find( modulo );
+     if ( found == cache.end() )
+     {
+          found = cache.emplace( modulo, make_prime( modulo ) ).first;
+     }
+     return found->second;
+}
+
+
+// the primality test and the root search run outside the lock
+size_t max_log( uint64_t modulo )
+{
+     {
+          std::lock_guard< std::mutex > lock{ cache_mutex() };
+          auto found = prime_cache().find( modulo );
+          if ( found != prime_cache().end() )
+          {
+               return found->second.max_log;
+          }
+     }
+     NttPrime prime = make_prime( modulo );
+     std::lock_guard< std::mutex > lock{ cache_mutex() };
+     return prime_cache().emplace( modulo, std::move( prime ) ).first->second.max_log;
+}
+
+
+void fill_twiddles( const ModReducer& red, uint64_t root, size_t n,
+                    std::vector< uint64_t >& twiddles, std::vector< uint64_t >& shoup )
+{
+     twiddles.assign( n, 0 );
+     shoup.assign( n, 0 );
+     uint64_t power = 1;
+     for ( size_t j = n / 2; j < n; j++ )
+     {
+          twiddles[ j ] = power;
+          power = red.mul( power, root );
+     }
+     for ( size_t j = n / 2; j-- > 1; )  // root of the lower level is the square
+     {
+          twiddles[ j ] = twiddles[ 2 * j ];
+     }
+     for ( size_t j = 1; j < n; j++ )
+     {
+          shoup[ j ] = static_cast< uint64_t >( ( static_cast< unsigned __int128 >( twiddles[ j ] ) << 64 ) / red.get_modulo() );
+     }
+}
+
+
+// twiddles for transforms of size 2^log, built once per modulo and size
+std::shared_ptr< const NttTwiddles > ntt_twiddles( uint64_t modulo, size_t log )
+{
+     std::lock_guard< std::mutex > lock{ cache_mutex() };
+     auto& prime = ntt_prime_locked( modulo );
+     size_t n = size_t{ 1 } << log;
+     if ( !prime.twiddles || prime.twiddles->size() < n )
+     {
+          ModReducer red{ modulo };
+          uint64_t root = pow_mod( red, prime.root, uint64_t{ 1 } << ( prime.max_log - log ) );
+          auto twiddles = std::make_shared< NttTwiddles >();
+          fill_twiddles( red, root, n, twiddles->forward, twiddles->forward_shoup );
+          fill_twiddles( red, pow_mod( red, root, modulo - 2 ), n, twiddles->inverse, twiddles->inverse_shoup );
+          prime.twiddles = std::move( twiddles );
+     }
+     return prime.twiddles;
+}
+
+
+size_t ceil_log2( size_t size )
+{
+     size_t log = 0;
+     while ( ( size_t{ 1 } << log ) < size )
+     {
+          log++;
+     }
+     return log;
+}
+
+
+// w * x mod p with the precomputed w_shoup = floor( w * 2^64 / p ):
+// one high and two low products, no reduction of a double word
+inline uint64_t mul_shoup( uint64_t x, uint64_t w, uint64_t w_shoup, uint64_t modulo )
+{
+     uint64_t q = static_cast< uint64_t >( ( static_cast< unsigned __int128 >( x ) * w_shoup ) >> 64 );
+     uint64_t r = x * w - q * modulo;
+     return ( r >= modulo ) ? r - modulo : r;
+}
+
+
+// in-place iterative transform of plain values, size at most twiddles.size()
+void transform( std::vector< uint64_t >& a, const ModReducer& red,
+                const std::vector< uint64_t >& twiddles, const std::vector< uint64_t >& shoup )
+{
+     size_t n = a.size();
+     uint64_t modulo = red.get_modulo();
+     for ( size_t i = 1, j = 0; i < n; i++ )  // bit reversal permutation
+     {
+          size_t bit = n >> 1;
+          for ( ; j & bit; bit >>= 1 )
+          {
+               j ^= bit;
+          }
+          j ^= bit;
+          if ( i < j )
+          {
+               std::swap( a[ i ], a[ j ] );
+          }
+     }
+     for ( size_t half = 1; half < n; half <<= 1 )
+     {
+          const uint64_t* tw = twiddles.data() + half;
+          const uint64_t* tw_shoup = shoup.data() + half;
+          for ( size_t start = 0; start < n; start += 2 * half )
+          {
+               uint64_t* lo = a.data() + start;
+               uint64_t* hi = lo + half;
+               for ( size_t j = 0; j < half; j++ )
+               {
+                    uint64_t u = lo[ j ], v = mul_shoup( hi[ j ], tw[ j ], tw_shoup[ j ], modulo );
+                    uint64_t sum = u + v, diff = u - v;
+                    // masks instead of branches: the comparisons are unpredictable
+                    lo[ j ] = sum - ( modulo & -static_cast< uint64_t >( sum >= modulo ) );
+                    hi[ j ] = diff + ( modulo & -static_cast< uint64_t >( u < v ) );
+               }
+          }
+     }
+}
+
+} // namespace
+
+
+bool ntt_supported( uint64_t modulo, size_t size )
+{
+     // moduli whose p - 1 lacks the power of 2 are rejected before
+     // any primality test or root search
+     size_t log = ceil_log2( size );
+     if ( log >= 63 || modulo < 3 || !( modulo & 1 ) || two_adicity( modulo ) < log )
+     {
+          return false;
+     }
+     return max_log( modulo ) >= log;
+}
+
+
+std::vector< uint64_t > ntt_multiply( const std::vector< uint64_t >& a,
+                                      const std::vector< uint64_t >& b, uint64_t modulo )
+{
+     if ( a.empty() || b.empty() )
+     {
+          return {};
+     }
+     size_t result_size = a.size() + b.size() - 1;
+     if ( !ntt_supported( modulo, result_size ) )
+     {
+          throw std::runtime_error{ "modulo does not support the transform of this size" };
+     }
+     size_t log = ceil_log2( result_size ), n = size_t{ 1 } << log;
+     auto twiddles = ntt_twiddles( modulo, log );
+     ModReducer red{ modulo };
+
+     std::vector< uint64_t > fa( n, 0 ), fb( n, 0 );
+     std::copy( a.begin(), a.end(), fa.begin() );
+     std::copy( b.begin(), b.end(), fb.begin() );
+     transform( fa, red, twiddles->forward, twiddles->forward_shoup );
+     transform( fb, red, twiddles->forward, twiddles->forward_shoup );
+     for ( size_t i = 0; i < n; i++ )
+     {
+          fa[ i ] = red.mul( fa[ i ], fb[ i ] );
+     }
+     transform( fa, red, twiddles->inverse, twiddles->inverse_shoup );
+     uint64_t n_inv = pow_mod( red, n % modulo, modulo - 2 );
+     fa.resize( result_size );
+     for ( auto& value : fa )
+     {
+          value = red.mul( value, n_inv );
+     }
+     return fa;
+}
@@ -0,0 +1,129 @@
+#include <polynomial/packed_monom.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+PackedMonom::PackedMonom( size_t vars ):
+     words_{ 0, 0 }, guards_{ 0 }
+{
+     if ( vars > max_vars )
+     {
+          throw std::runtime_error{ "too many variables to pack" };
+     }
+     vars_ = static_cast< uint32_t >( vars );
+     per_word_ = std::max< uint32_t >( ( vars_ + 1 ) / 2, 1 );
+     // fields no wider than 32 bits, exponents above their limit do not pack
+     bits_ = std::min< unsigned >( 64 / per_word_, 32 );
+     for ( uint32_t i = 0; i < per_word_; i++ )
+     {
+          guards_ |= uint64_t{ 1 } << ( i * bits_ + bits_ - 1 );
+     }
+}
+
+
+bool PackedMonom::assign( const Monom& monom )
+{
+     const auto& exps = monom.exps();
+     if ( exps.size() > vars_ )
+     {
+          return false;
+     }
+     uint64_t limit = ( uint64_t{ 1 } << ( bits_ - 1 ) ) - 1;
+     uint64_t words[ 2 ] = { 0, 0 };
+     for ( size_t i = 0; i < exps.size(); i++ )
+     {
+          if ( exps[ i ] > limit )
+          {
+               return false;
+          }
+          words[ i / per_word_ ] |= uint64_t{ exps[ i ] } << ( i % per_word_ * bits_ );
+     }
+     words_[ 0 ] = words[ 0 ];
+     words_[ 1 ] = words[ 1 ];
+     return true;
+}
+
+
+Monom PackedMonom::unpack( const PolyRing& ring ) const
+{
+     std::vector< Monom::exponent_type > exps( vars_ );
+     for ( size_t i = 0; i < vars_; i++ )
+     {
+          exps[ i ] = static_cast< Monom::exponent_type >( var_deg( i ) );
+     }
+     return Monom{ ring, std::move( exps ) };
+}
+
+
+// fields sum below their guard bits unless an exponent overflows
+PackedMonom& PackedMonom::operator*= ( const PackedMonom& other )
+{
+     check_layout( other );
+     uint64_t low = words_[ 0 ] + other.words_[ 0 ];
+     uint64_t high = words_[ 1 ] + other.words_[ 1 ];
+     if ( ( low | high ) & guards_ )
+     {
+          throw std::runtime_error{ "monomial exponent overflow" };
+     }
+     words_[ 0 ] = low;
+     words_[ 1 ] = high;
+     return *this;
+}
+
+
+bool PackedMonom::operator== ( const PackedMonom& other ) const
+{
+     check_layout( other );
+     return words_[ 0 ] == other.words_[ 0 ] && words_[ 1 ] == other.words_[ 1 ];
+}
+
+
+bool PackedMonom::operator!= ( const PackedMonom& other ) const
+{
+     return !( *this == other );
+}
+
+
+// a field of ( a | guard ) - b keeps its guard bit exactly when a >= b
+bool PackedMonom::is_divisible( const PackedMonom& other ) const
+{
+     check_layout( other );
+     return ( ( ( words_[ 0 ] | guards_ ) - other.words_[ 0 ] ) & guards_ ) == guards_
+         && ( ( ( words_[ 1 ] | guards_ ) - other.words_[ 1 ] ) & guards_ ) == guards_;
+}
+
+
+size_t PackedMonom::var_deg( size_t index ) const
+{
+     if ( index >= vars_ )
+     {
+          return 0;
+     }
+     uint64_t mask = ( uint64_t{ 1 } << ( bits_ - 1 ) ) - 1;
+     return ( words_[ index / per_word_ ] >> ( index % per_word_ * bits_ ) ) & mask;
+}
+
+
+size_t PackedMonom::vars() const
+{
+     return vars_;
+}
+
+
+unsigned PackedMonom::field_bits() const
+{
+     return bits_;
+}
+
+
+void PackedMonom::check_layout( const PackedMonom& other ) const
+{
+     if ( vars_ != other.vars_ )
+     {
+          throw std::runtime_error{ "packed monomials of different layouts" };
+     }
+}
+
+
+PackedMonom operator* ( PackedMonom lhs, const PackedMonom& rhs ) { return lhs *= rhs; }
@@ -0,0 +1,98 @@
+#include <polynomial/poly_ring.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+std::atomic< uint64_t > next_ring_id{ 0 };
+
+} // namespace
+
+
+PolyRing::PolyRing( const std::vector< std::string >& vars ):
+     id_{ next_ring_id++ }
+{
+     tables_.push_back( std::make_unique< const Table >() );
+     table_.store( tables_.back().get(), std::memory_order_release );
+     for ( const auto& var : vars )
+     {
+          intern( var );
+     }
+}
+
+
+const PolyRing& PolyRing::default_ring()
+{
+     static const PolyRing ring;
+     return ring;
+}
+
+
+size_t PolyRing::intern( const std::string& var ) const
+{
+     size_t found = find( var );
+     if ( found != npos )
+     {
+          return found;
+     }
+     std::lock_guard< std::mutex > lock{ mutex_ };
+     const Table* current = table_.load( std::memory_order_acquire );
+     auto again = current->index.find( var );
+     if ( again != current->index.end() )
+     {
+          return again->second;     // interned by another thread meanwhile
+     }
+     size_t index = current->names.size();
+     if ( index >= UINT32_MAX )
+     {
+          throw std::runtime_error{ "too many variables" };
+     }
+     auto table = std::make_unique< Table >( *current );
+     names_.push_back( var );
+     const std::string& stored = names_.back();
+     table->index.emplace( stored, static_cast< uint32_t >( index ) );
+     table->names.push_back( &stored );
+     // keep order sorted by name: the new index goes before the first greater name
+     auto pos = std::upper_bound( table->order.begin(), table->order.end(), var, [ & ]( const std::string& name, uint32_t i )
+     {
+          return name < *table->names[ i ];
+     } );
+     table->order.insert( pos, static_cast< uint32_t >( index ) );
+     tables_.push_back( std::move( table ) );
+     table_.store( tables_.back().get(), std::memory_order_release );
+     return index;
+}
+
+
+size_t PolyRing::find( const std::string& var ) const
+{
+     const Table* table = table_.load( std::memory_order_acquire );
+     auto found = table->index.find( std::string_view{ var } );
+     return ( found == table->index.end() ) ? npos : found->second;
+}
+
+
+const std::string& PolyRing::name( size_t index ) const
+{
+     return *table_.load( std::memory_order_acquire )->names.at( index );
+}
+
+
+size_t PolyRing::size() const
+{
+     return table_.load( std::memory_order_acquire )->names.size();
+}
+
+
+const std::vector< uint32_t >& PolyRing::order() const
+{
+     return table_.load( std::memory_order_acquire )->order;
+}
+
+
+uint64_t PolyRing::id() const
+{
+     return id_;
+}
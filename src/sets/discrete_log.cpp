@@ -0,0 +1,264 @@
+#include <sets/discrete_log.h>
+#include <sets/primality.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+
+using wide_type = unsigned __int128;
+
+
+// prime subgroups up to this order get baby-step giant-step tables
+// of sqrt( p ) entries, larger ones are searched with Pollard's rho
+const uint64_t bsgs_limit = uint64_t{ 1 } << 32;
+
+
+struct LogSlot
+{
+     std::once_flag once;
+     std::unique_ptr< Gf2DiscreteLog > engine;
+};
+
+
+uint64_t add_mod( uint64_t a, uint64_t b, uint64_t m )
+{
+     return static_cast< uint64_t >( ( static_cast< wide_type >( a ) + b ) % m );
+}
+
+
+uint64_t mul_mod( uint64_t a, uint64_t b, uint64_t m )
+{
+     return static_cast< uint64_t >( static_cast< wide_type >( a ) * b % m );
+}
+
+
+// a^-1 mod m for gcd( a, m ) = 1
+uint64_t inv_mod( uint64_t a, uint64_t m )
+{
+     __int128 r0 = m, r1 = a % m, t0 = 0, t1 = 1;
+     while ( r1 != 0 )
+     {
+          __int128 q = r0 / r1, tmp = r0 - q * r1;
+          r0 = r1;
+          r1 = tmp;
+          tmp = t0 - q * t1;
+          t0 = t1;
+          t1 = tmp;
+     }
+     if ( r0 != 1 )
+     {
+          throw std::runtime_error{ "not invertible element" };
+     }
+     return static_cast< uint64_t >( t0 < 0 ? t0 + m : t0 );
+}
+
+
+uint64_t int_pow( uint64_t base, size_t exp )
+{
+     uint64_t result = 1;
+     for ( size_t i = 0; i < exp; i++ )
+     {
+          result *= base;
+     }
+     return result;
+}
+
+} // namespace
+
+
+const Gf2DiscreteLog& Gf2DiscreteLog::get( const Gf2Reducer& field )
+{
+     static std::map< std::pair< size_t, uint64_t >, LogSlot > registry;
+     static std::mutex mutex;
+     LogSlot* slot;
+     {
+          std::lock_guard< std::mutex > lock{ mutex };
+          slot = &registry[ { field.degree(), field.poly() } ];
+     }
+     std::call_once( slot->once, [ & ]()
+     {
+          slot->engine = std::make_unique< Gf2DiscreteLog >( field );
+     } );
+     return *slot->engine;
+}
+
+
+Gf2DiscreteLog::Gf2DiscreteLog( const Gf2Reducer& field ):
+     field_{ field }, root_{ 0 }, order_{ 0 }
+{
+     size_t degree = field_.degree();
+     if ( degree == 0 )
+     {
+          return;
+     }
+     root_ = ( degree > 1 ) ? 2 : field_.poly();    // x mod f
+     uint64_t group_order = field_.mask();          // 2^n - 1
+     if ( root_ == 0 || field_.pow( root_, group_order ) != 1 )
+     {
+          return;      // x is not invertible, f is reducible
+     }
+     // order of x: drop the prime factors of the group order it does not need
+     auto factors = factorize( group_order );
+     order_ = group_order;
+     for ( const auto& factor : factors )
+     {
+          while ( order_ % factor.first == 0 && field_.pow( root_, order_ / factor.first ) == 1 )
+          {
+               order_ /= factor.first;
+          }
+     }
+     for ( const auto& factor : factors )
+     {
+          Subgroup group;
+          group.p = factor.first;
+          for ( uint64_t rest = order_; rest % group.p == 0; rest /= group.p )
+          {
+               group.exp++;
+          }
+          if ( group.exp == 0 )
+          {
+               continue;
+          }
+          group.generator = field_.pow( root_, order_ / group.p );
+          if ( group.p <= bsgs_limit )
+          {
+               while ( group.steps * group.steps < group.p )
+               {
+                    group.steps++;
+               }
+               group.baby.reserve( group.steps );
+               for ( uint64_t j = 0, value = 1; j < group.steps; j++ )
+               {
+                    group.baby.emplace_back( value, j );
+                    value = field_.mul( value, group.generator );
+               }
+               std::sort( group.baby.begin(), group.baby.end() );
+               group.giant = field_.pow( group.generator, group.p - group.steps % group.p );
+          }
+          subgroups_.push_back( std::move( group ) );
+     }
+}
+
+
+uint64_t Gf2DiscreteLog::order() const
+{
+     return order_;
+}
+
+
+// Pohlig-Hellman: the logarithm modulo each p^exp digit by digit in
+// the subgroup of order p, then the Chinese remainder theorem
+uint64_t Gf2DiscreteLog::log( uint64_t a ) const
+{
+     a &= field_.mask();
+     if ( a == 0 )
+     {
+          throw std::runtime_error{ "zero is not in multiplicative group" };
+     }
+     if ( order_ == 0 || field_.pow( a, order_ ) != 1 )
+     {
+          throw std::runtime_error{ "element is not a power of the primitive element" };
+     }
+     uint64_t result = 0, modulus = 1;
+     for ( const auto& group : subgroups_ )
+     {
+          uint64_t prime_power = int_pow( group.p, group.exp );
+          uint64_t g = field_.pow( root_, order_ / prime_power );
+          uint64_t h = field_.pow( a, order_ / prime_power );
+          uint64_t g_inv = field_.inv( g );
+          uint64_t digits = 0, weight = 1;
+          for ( size_t k = 0; k < group.exp; k++ )
+          {
+               uint64_t t = field_.mul( h, field_.pow( g_inv, digits ) );
+               t = field_.pow( t, int_pow( group.p, group.exp - 1 - k ) );
+               digits += subgroup_log( group, t ) * weight;
+               weight *= group.p;
+          }
+          // result = digits mod prime_power and result mod modulus kept
+          uint64_t diff = ( digits + prime_power - result % prime_power ) % prime_power;
+          uint64_t lift = mul_mod( diff, inv_mod( modulus % prime_power, prime_power ), prime_power );
+          result += lift * modulus;
+          modulus *= prime_power;
+     }
+     if ( field_.pow( root_, result ) != a )
+     {
+          throw std::runtime_error{ "element is not a power of the primitive element" };
+     }
+     return result;
+}
+
+
+uint64_t Gf2DiscreteLog::subgroup_log( const Subgroup& group, uint64_t h ) const
+{
+     if ( h == 1 )
+     {
+          return 0;
+     }
+     if ( group.steps == 0 )
+     {
+          return rho_log( group, h );
+     }
+     uint64_t gamma = h;
+     for ( uint64_t i = 0; i < group.steps; i++ )
+     {
+          auto found = std::lower_bound( group.baby.begin(), group.baby.end(), std::make_pair( gamma, uint64_t{ 0 } ) );
+          if ( found != group.baby.end() && found->first == gamma )
+          {
+               return ( i * group.steps + found->second ) % group.p;
+          }
+          gamma = field_.mul( gamma, group.giant );
+     }
+     throw std::runtime_error{ "element is not a power of the primitive element" };
+}
+
+
+// r-adding walk y -> y * g^u[ s ] * h^v[ s ] with y = g^a * h^b, the branch s
+// from a hash of y; Floyd's cycle search finds g^a1 h^b1 = g^a2 h^b2
+uint64_t Gf2DiscreteLog::rho_log( const Subgroup& group, uint64_t h ) const
+{
+     const size_t branches = 16;
+     const uint64_t p = group.p;
+     std::mt19937_64 random{ p ^ h };
+     for ( ;; )
+     {
+          std::array< uint64_t, branches > u, v, step;
+          for ( size_t s = 0; s < branches; s++ )
+          {
+               u[ s ] = random() % p;
+               v[ s ] = random() % p;
+               step[ s ] = field_.mul( field_.pow( group.generator, u[ s ] ), field_.pow( h, v[ s ] ) );
+          }
+          auto walk = [ & ]( uint64_t& y, uint64_t& a, uint64_t& b )
+          {
+               size_t s = ( y * 0x9e3779b97f4a7c15ull ) >> 60;
+               y = field_.mul( y, step[ s ] );
+               a = add_mod( a, u[ s ], p );
+               b = add_mod( b, v[ s ], p );
+          };
+          uint64_t a1 = random() % p, b1 = 0;
+          uint64_t y1 = field_.pow( group.generator, a1 ), a2 = a1, b2 = b1, y2 = y1;
+          do
+          {
+               walk( y1, a1, b1 );
+               walk( y2, a2, b2 );
+               walk( y2, a2, b2 );
+          } while ( y1 != y2 );
+          if ( b1 != b2 )
+          {
+               // g^( a1 - a2 ) = h^( b2 - b1 )
+               uint64_t num = add_mod( a1, p - a2, p ), den = add_mod( b2, p - b1, p );
+               uint64_t k = mul_mod( num, inv_mod( den, p ), p );
+               if ( field_.pow( group.generator, k ) == h )
+               {
+                    return k;
+               }
+          }
+     }
+}
@@ -1,34 +1,133 @@
 #include <sets/galois_2n.h>
+#include <sets/galois_table.h>
+#include <sets/discrete_log.h>
+
 #include <stdexcept>
 
-Galois2N::Galois2N( const polynom_type& irreducible, const polynom_type& coeffs ) noexcept:
-     irr_pol_{ irreducible }, basis_coeffs_{ coeffs }
+namespace
+{
+
+using polynom_type = Galois2N::polynom_type;
+
+
+// field elements of degree <= 64 fit a word
+uint64_t word_of( const polynom_type& coeffs )
+{
+     return coeffs.to_ulong();
+}
+
+
+std::vector< uint64_t > words_of( const polynom_type& coeffs )
+{
+     std::vector< uint64_t > words( coeffs.num_blocks() );
+     boost::to_block_range( coeffs, words.begin() );
+     return words;
+}
+
+
+polynom_type from_words( const std::vector< uint64_t >& words, size_t size )
+{
+     polynom_type pol( words.begin(), words.end() );
+     pol.resize( size );
+     return pol;
+}
+
+
+// replaces the bits of pol, reuses its storage
+void set_word( polynom_type& pol, uint64_t value, size_t size )
+{
+     pol.clear();
+     pol.append( value );
+     pol.resize( size );
+}
+
+
+// per-thread word buffers for wide fields: they only grow, so arithmetic
+// on existing elements copies blocks in and out without heap traffic
+struct Scratch
 {
-     if ( irr_pol_.any() )
+     std::vector< uint64_t > a, b, wide;
+};
+
+
+Scratch& scratch( size_t words )
+{
+     thread_local Scratch buffers;
+     if ( buffers.a.size() < words )
      {
-          basis_coeffs_.resize( irr_pol_.size() - 1 );
+          buffers.a.resize( words );
+          buffers.b.resize( words );
+          buffers.wide.resize( 2 * words );
      }
+     return buffers;
 }
 
 
+// the blocks of pol are overwritten in place, bits past its size must be clear
+void store( polynom_type& pol, const uint64_t* words )
+{
+     boost::from_block_range( words, words + pol.num_blocks(), pol );
+}
+
+} // namespace
+
+
+Galois2N::Galois2N( const polynom_type& irreducible, const polynom_type& coeffs ) noexcept:
+     Galois2N{ Galois2NField::get( irreducible ), coeffs } {}
+
+
 Galois2N::Galois2N( const polynom_type& irreducible, size_t power ) noexcept:
-     irr_pol_{ irreducible }
+     Galois2N{ Galois2NField::get( irreducible ), power } {}
+
+
+Galois2N::Galois2N( const Galois2NField* field, const polynom_type& coeffs ) noexcept:
+     field_{ field }, basis_coeffs_{ coeffs }
 {
-     power %= ( irr_pol_.size() - 1 ) * ( irr_pol_.size() - 1 ) - 1;
-     basis_coeffs_ = polynom_type( std::max( power + 1, irr_pol_.size() - 1 ) );
-     basis_coeffs_.set( power );	// make polynomial x^power
-     pol_mod( basis_coeffs_, irr_pol_ );
-     basis_coeffs_.resize( irr_pol_.size() - 1 );
+     if ( field_ )
+     {
+          basis_coeffs_.resize( field_->degree() );
+     }
+}
+
+
+Galois2N::Galois2N( const Galois2NField* field, size_t power ) noexcept:
+     field_{ field }
+{
+     if ( !field_ )
+     {
+          return;
+     }
+     size_t degree = field_->degree();
+     if ( auto table = field_->table() )
+     {
+          set_word( basis_coeffs_, table->exp( power ), degree );
+          return;
+     }
+     if ( degree < 64 )
+     {
+          power %= ( size_t{ 1 } << degree ) - 1;   // order of the multiplicative group
+     }
+     if ( field_->is_word() )
+     {
+          const auto& red = field_->reducer();
+          uint64_t root = ( degree > 1 ) ? 2 : red.poly();     // x mod f
+          set_word( basis_coeffs_, red.pow( root, power ), degree );
+          return;
+     }
+     std::vector< uint64_t > words( field_->wide_reducer().words(), 0 );
+     words[ 0 ] = 2;      // x
+     field_->wide_reducer().pow( words.data(), words.data(), power );
+     basis_coeffs_ = from_words( words, degree );
 }
 
 
 Galois2N::Galois2N( const Galois2N& other ) noexcept:
-     irr_pol_{ other.irr_pol_ }, basis_coeffs_{ other.basis_coeffs_ } {}
+     field_{ other.field_ }, basis_coeffs_{ other.basis_coeffs_ } {}
 
 
-Galois2N::Galois2N( Galois2N&& other ) noexcept
+Galois2N::Galois2N( Galois2N&& other ) noexcept:
+     field_{ other.field_ }
 {
-     irr_pol_.swap( other.irr_pol_ );
      basis_coeffs_.swap( other.basis_coeffs_ );
 }
 
@@ -37,7 +136,7 @@ Galois2N& Galois2N::operator= ( const Galois2N& other ) noexcept
 {
      if ( &other != this )
      {
-          irr_pol_ = other.irr_pol_;
+          field_ = other.field_;
           basis_coeffs_ = other.basis_coeffs_;
      }
      return *this;
@@ -48,7 +147,7 @@ Galois2N& Galois2N::operator= ( Galois2N&& other ) noexcept
 {
      if ( &other != this )
      {
-          irr_pol_.swap( other.irr_pol_ );
+          field_ = other.field_;
           basis_coeffs_.swap( other.basis_coeffs_ );
      }
      return *this;
@@ -66,7 +165,7 @@ Galois2N& Galois2N::operator+= ( const Galois2N& other )
           *this = other;
           return *this;
      }
-     if ( irr_pol_ != other.irr_pol_ )
+     if ( field_ != other.field_ )
      {
           throw std::runtime_error{ "operands are from different fields" };
      }
@@ -85,32 +184,116 @@ Galois2N& Galois2N::operator*= ( const Galois2N& other )
 {
      if ( !other || !( *this ) )
      {
-          *this = Galois2N{};
+          basis_coeffs_.reset();
           return *this;
      }
-     if ( irr_pol_ != other.irr_pol_ )
+     if ( field_ != other.field_ )
      {
           throw std::runtime_error{ "operands are from different fields" };
      }
-     pol_mul( basis_coeffs_, other.basis_coeffs_ );
-     shrink( basis_coeffs_ );
-     pol_mod( basis_coeffs_, irr_pol_ );
-     basis_coeffs_.resize( irr_pol_.size() - 1 );
+     if ( auto table = field_->table() )
+     {
+          set_word( basis_coeffs_, table->mul( word_of( basis_coeffs_ ), word_of( other.basis_coeffs_ ) ), basis_coeffs_.size() );
+          return *this;
+     }
+     if ( field_->is_word() )
+     {
+          set_word( basis_coeffs_, field_->reducer().mul( word_of( basis_coeffs_ ), word_of( other.basis_coeffs_ ) ), basis_coeffs_.size() );
+          return *this;
+     }
+     const auto& red = field_->wide_reducer();
+     auto& buf = scratch( red.words() );
+     boost::to_block_range( basis_coeffs_, buf.a.begin() );
+     boost::to_block_range( other.basis_coeffs_, buf.b.begin() );
+     red.mul( buf.a.data(), buf.a.data(), buf.b.data(), buf.wide.data() );
+     store( basis_coeffs_, buf.a.data() );
      return *this;
 }
 
 
 Galois2N& Galois2N::operator/= ( const Galois2N& other )
 {
+     if ( !other )
+     {
+          throw std::runtime_error{ "division by zero" };
+     }
      if ( !( *this ) )
      {
           return *this;
      }
-     if ( other && irr_pol_ != other.irr_pol_ )
+     if ( field_ != other.field_ )
+     {
+          throw std::runtime_error{ "operands are from different fields" };
+     }
+     if ( auto table = field_->table() )
+     {
+          set_word( basis_coeffs_, table->div( word_of( basis_coeffs_ ), word_of( other.basis_coeffs_ ) ), basis_coeffs_.size() );
+          return *this;
+     }
+     if ( field_->is_word() )
+     {
+          const auto& red = field_->reducer();
+          set_word( basis_coeffs_, red.mul( word_of( basis_coeffs_ ), red.inv( word_of( other.basis_coeffs_ ) ) ), basis_coeffs_.size() );
+          return *this;
+     }
+     const auto& red = field_->wide_reducer();
+     auto& buf = scratch( red.words() );
+     boost::to_block_range( basis_coeffs_, buf.a.begin() );
+     boost::to_block_range( other.basis_coeffs_, buf.b.begin() );
+     red.inv( buf.b.data(), buf.b.data() );
+     red.mul( buf.a.data(), buf.a.data(), buf.b.data(), buf.wide.data() );
+     store( basis_coeffs_, buf.a.data() );
+     return *this;
+}
+
+
+// the product stays in a word or in scratch until the sum is written back,
+// so add may alias *this or mul
+Galois2N& Galois2N::fma( const Galois2N& mul, const Galois2N& add )
+{
+     if ( !mul || !( *this ) )
+     {
+          if ( &add != this )
+          {
+               basis_coeffs_.reset();
+               *this += add;
+          }
+          return *this;
+     }
+     if ( field_ != mul.field_ || ( add && field_ != add.field_ ) )
      {
           throw std::runtime_error{ "operands are from different fields" };
      }
-     return *this *= other.inv();
+     if ( field_->is_word() )
+     {
+          uint64_t addend = add ? word_of( add.basis_coeffs_ ) : 0;
+          uint64_t product;
+          if ( auto table = field_->table() )
+          {
+               product = table->mul( word_of( basis_coeffs_ ), word_of( mul.basis_coeffs_ ) );
+          }
+          else
+          {
+               product = field_->reducer().mul( word_of( basis_coeffs_ ), word_of( mul.basis_coeffs_ ) );
+          }
+          set_word( basis_coeffs_, product ^ addend, basis_coeffs_.size() );
+          return *this;
+     }
+     const auto& red = field_->wide_reducer();
+     auto& buf = scratch( red.words() );
+     boost::to_block_range( basis_coeffs_, buf.a.begin() );
+     boost::to_block_range( mul.basis_coeffs_, buf.b.begin() );
+     red.mul( buf.a.data(), buf.a.data(), buf.b.data(), buf.wide.data() );
+     if ( add )
+     {
+          boost::to_block_range( add.basis_coeffs_, buf.b.begin() );
+          for ( size_t i = 0; i < red.words(); i++ )
+          {
+               buf.a[ i ] ^= buf.b[ i ];
+          }
+     }
+     store( basis_coeffs_, buf.a.data() );
+     return *this;
 }
 
 
@@ -125,7 +308,7 @@ bool Galois2N::operator== ( const Galois2N& other ) const
      {
           return true;
      }
-     return ( other.irr_pol_ == irr_pol_ ) && ( other.basis_coeffs_ == basis_coeffs_ );
+     return ( other.field_ == field_ ) && ( other.basis_coeffs_ == basis_coeffs_ );
 }
 
 
@@ -145,7 +328,7 @@ bool Galois2N::operator> ( const Galois2N& other ) const
      {
           return true;
      }
-     if ( irr_pol_ != other.irr_pol_ )
+     if ( field_ != other.field_ )
      {
           throw std::runtime_error{ "operands are from different fields" };
      }
@@ -173,7 +356,7 @@ bool Galois2N::operator<= ( const Galois2N& other ) const
 
 Galois2N::operator bool() const
 {
-     return basis_coeffs_.any() && irr_pol_.any();
+     return field_ && basis_coeffs_.any();
 }
 
 
@@ -183,32 +366,18 @@ Galois2N Galois2N::inv() const
      {
           throw std::runtime_error{ "division by zero" };
      }
-     // extended euclidean algorithm
-     polynom_type t{ irr_pol_.size() }, newt{ 1, 1 };
-     polynom_type r{ irr_pol_ }, newr{ basis_coeffs_ };
-     while ( newr.any() )
-     {
-          shrink( newr );
-          shrink( newt );
-          auto quotient = r;
-          pol_div( quotient, newr );
-          auto tmp = quotient;
-          pol_mul( tmp, newr );
-          tmp.resize( std::max( r.size(), tmp.size() ) );
-          r.resize( tmp.size() );
-          tmp  = r ^ tmp;
-          r    = newr;
-          newr = tmp;
-          tmp  = quotient;
-          pol_mul( tmp, newt );
-          tmp.resize( std::max( t.size(), tmp.size() ) );
-          t.resize( tmp.size() );
-          tmp  = t ^ tmp;
-          t    = newt;
-          newt = tmp;
-     }
-     t.resize( irr_pol_.size()-1 );
-     return Galois2N{ irr_pol_, t };
+     size_t degree = field_->degree();
+     if ( auto table = field_->table() )
+     {
+          return Galois2N{ field_, polynom_type( degree, table->inv( word_of( basis_coeffs_ ) ) ) };
+     }
+     if ( field_->is_word() )
+     {
+          return Galois2N{ field_, polynom_type( degree, field_->reducer().inv( word_of( basis_coeffs_ ) ) ) };
+     }
+     auto words = words_of( basis_coeffs_ );
+     field_->wide_reducer().inv( words.data(), words.data() );
+     return Galois2N{ field_, from_words( words, degree ) };
 }
 
 
@@ -219,14 +388,23 @@ size_t Galois2N::prim_power() const
      {
           throw std::runtime_error{ "zero is not in multiplicative group" };
      }
+     if ( auto table = field_->table() )
+     {
+          return table->log( word_of( basis_coeffs_ ) );
+     }
+     if ( field_->is_word() )
+     {
+          return Gf2DiscreteLog::get( field_->reducer() ).log( word_of( basis_coeffs_ ) );
+     }
+     const auto& irr_pol = field_->irreducible_pol();
      auto coeffs = basis_coeffs_;
-     coeffs.resize( irr_pol_.size() );
+     coeffs.resize( irr_pol.size() );
      size_t power = coeffs.find_first();
      size_t shift_len = power;
      while ( coeffs.count() > 1 )
      {
           coeffs >>= shift_len;
-          coeffs ^= irr_pol_;
+          coeffs ^= irr_pol;
           shift_len = coeffs.find_first();
           power += shift_len;
      }
@@ -234,80 +412,22 @@ size_t Galois2N::prim_power() const
 }
 
 
-const Galois2N::polynom_type& Galois2N::irreducible_pol() const
+const Galois2NField* Galois2N::field() const
 {
-     return irr_pol_;
+     return field_;
 }
 
 
-const Galois2N::polynom_type& Galois2N::coeffs() const
-{
-     return basis_coeffs_;
-}
-
-
-// remove leading zeroes until pol.size() == size
-void Galois2N::shrink( polynom_type& pol, size_t size )
+const Galois2N::polynom_type& Galois2N::irreducible_pol() const
 {
-     while ( pol.size() > size && !pol.test( pol.size() - 1 ) )
-     {
-          pol.pop_back();
-     }
+     static const polynom_type none;
+     return field_ ? field_->irreducible_pol() : none;
 }
 
 
-// pol and mul must monic polynomials (leading coeff. == 1)
-// this function does "pol %= mul", pol will be monic
-void Galois2N::pol_mod( polynom_type& pol, const polynom_type& divisor )
+const Galois2N::polynom_type& Galois2N::coeffs() const
 {
-     while ( pol.size() >= divisor.size() )
-     {
-          auto product = divisor;
-          product.resize( pol.size() );
-          product <<= pol.size() - divisor.size();
-          pol ^= product;
-          shrink( pol );
-     }
-}
-
-
-// pol and mul must monic polynomials (leading coeff. == 1)
-// this function does "pol /= mul", pol will be monic
-void Galois2N::pol_div( polynom_type& pol, const polynom_type& divisor ) {
-	polynom_type result( pol.size() );
-	while ( pol.size() >= divisor.size() )
-     {
-          auto product = divisor;
-          auto shift_len = pol.size() - divisor.size();
-          result.set( shift_len );
-          product.resize( pol.size() );
-          product <<= shift_len;
-          pol ^= product;
-          shrink( pol );
-	}
-	shrink( result );
-	pol = std::move( result );
-}
-
-
-// pol and mul must monic polynomials (leading coeff. == 1)
-// this function does "pol *= mul", pol will be monic
-void Galois2N::pol_mul( polynom_type& pol, const polynom_type& mul ) {
-	if ( pol.none() )
-     {
-          return;
-     }
-     polynom_type result( pol.size() + mul.size() - 1 );
-     auto pos = mul.find_first();
-     while (pos != polynom_type::npos)
-     {
-          auto component = pol;
-          component.resize( pol.size() + mul.size() - 1 );
-          component <<= pos;
-          result ^= component;
-          pos = mul.find_next( pos );
-	}
-	pol = result;
+     return basis_coeffs_;
 }
 
 Galois2N operator+ ( Galois2N a, const Galois2N& b ) { return a += b; }
@@ -322,5 +442,16 @@ Galois2N pow( const Galois2N& base, size_t exp )
      {
           return base;
      }
-     return Galois2N{ base.irreducible_pol(), base.prim_power() * exp };
+     const auto* field = base.field();
+     if ( auto table = field->table() )
+     {
+          return Galois2N{ field, polynom_type( field->degree(), table->pow( word_of( base.coeffs() ), exp ) ) };
+     }
+     if ( field->is_word() )
+     {
+          return Galois2N{ field, polynom_type( field->degree(), field->reducer().pow( word_of( base.coeffs() ), exp ) ) };
+     }
+     auto words = words_of( base.coeffs() );
+     field->wide_reducer().pow( words.data(), words.data(), exp );
+     return Galois2N{ field, from_words( words, field->degree() ) };
 }
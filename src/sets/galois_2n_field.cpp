@@ -0,0 +1,120 @@
+#include <sets/galois_2n_field.h>
+#include <sets/gf2_polynomials.h>
+
+#include <map>
+#include <memory>
+
+namespace
+{
+
+using polynom_type = Galois2NField::polynom_type;
+
+
+struct PolynomLess
+{
+     bool operator() ( const polynom_type& a, const polynom_type& b ) const
+     {
+          return ( a.size() != b.size() ) ? a.size() < b.size() : a < b;
+     }
+};
+
+} // namespace
+
+
+const Galois2NField* Galois2NField::get( const polynom_type& irreducible )
+{
+     if ( irreducible.none() )
+     {
+          return nullptr;
+     }
+     // elements of one field are created together, the last field
+     // of this thread is found without taking the lock
+     thread_local polynom_type cached_pol;
+     thread_local const Galois2NField* cached = nullptr;
+     if ( cached && irreducible == cached_pol )
+     {
+          return cached;
+     }
+     auto pol = irreducible;
+     while ( !pol.test( pol.size() - 1 ) )
+     {
+          pol.pop_back();
+     }
+     static std::map< polynom_type, std::unique_ptr< Galois2NField >, PolynomLess > registry;
+     static std::mutex mutex;
+     {
+          std::lock_guard< std::mutex > lock{ mutex };
+          auto& field = registry[ pol ];
+          if ( !field )
+          {
+               field.reset( new Galois2NField{ pol } );
+          }
+          cached = field.get();
+     }
+     cached_pol = irreducible;
+     return cached;
+}
+
+
+const Galois2NField* Galois2NField::get( size_t degree )
+{
+     return get( ( degree <= 64 ) ? primitive_polynom( degree ) : irreducible_polynom( degree ) );
+}
+
+
+Galois2NField::Galois2NField( const polynom_type& irreducible ):
+     irr_pol_{ irreducible }
+{
+     std::vector< uint64_t > words( irr_pol_.num_blocks() );
+     boost::to_block_range( irr_pol_, words.begin() );
+     wide_reducer_ = Gf2WideReducer{ degree(), std::move( words ) };
+     if ( is_word() )
+     {
+          uint64_t poly = 0;
+          for ( size_t i = 0; i < degree(); i++ )
+          {
+               poly |= static_cast< uint64_t >( irr_pol_.test( i ) ) << i;
+          }
+          reducer_ = Gf2Reducer{ degree(), poly };
+     }
+}
+
+
+size_t Galois2NField::degree() const
+{
+     return irr_pol_.size() - 1;
+}
+
+
+const Galois2NField::polynom_type& Galois2NField::irreducible_pol() const
+{
+     return irr_pol_;
+}
+
+
+bool Galois2NField::is_word() const
+{
+     return degree() >= 1 && degree() <= 64;
+}
+
+
+const Gf2Reducer& Galois2NField::reducer() const
+{
+     return reducer_;
+}
+
+
+const Gf2WideReducer& Galois2NField::wide_reducer() const
+{
+     return wide_reducer_;
+}
+
+
+const GaloisTable* Galois2NField::table() const
+{
+     std::call_once( table_once_, [ this ]()
+     {
+          table_ = GaloisTable::get( degree(), reducer_.poly() );
+     } );
+     return table_;
+}
@@ -0,0 +1,227 @@
+#include <sets/galois_64.h>
+
+#include <stdexcept>
+
+namespace
+{
+
+uint64_t to_word( const Galois64::polynom_type& pol, size_t size )
+{
+     uint64_t word = 0;
+     for ( size_t i = 0; i < pol.size() && i < size; i++ )
+     {
+          if ( pol.test( i ) )
+          {
+               word |= uint64_t{ 1 } << i;
+          }
+     }
+     return word;
+}
+
+} // namespace
+
+
+Galois64::Galois64( const Galois2NField* field, uint64_t coeffs ) noexcept:
+     field_{ field }, value_{ field ? coeffs & field->reducer().mask() : 0 } {}
+
+
+Galois64::Galois64( const polynom_type& irreducible, const polynom_type& coeffs ):
+     field_{ make_field( irreducible ) }, value_{ field_ ? to_word( coeffs, field_->degree() ) : 0 } {}
+
+
+Galois64::Galois64( const Galois2N& other ):
+     field_{ other.field() }, value_{ 0 }
+{
+     if ( field_ && !field_->is_word() )
+     {
+          throw std::runtime_error{ "field degree must be in [1, 64]" };
+     }
+     value_ = field_ ? to_word( other.coeffs(), field_->degree() ) : 0;
+}
+
+
+Galois64& Galois64::operator+= ( const Galois64& other )
+{
+     if ( check_field( other ) )
+     {
+          value_ ^= other.value_;
+     }
+     return *this;
+}
+
+
+Galois64& Galois64::operator-= ( const Galois64& other )
+{
+     return *this += other;
+}
+
+
+Galois64& Galois64::operator*= ( const Galois64& other )
+{
+     if ( !other || !( *this ) )
+     {
+          *this = Galois64{};
+          return *this;
+     }
+     if ( field_ != other.field_ )
+     {
+          throw std::runtime_error{ "operands are from different fields" };
+     }
+     value_ = field_->reducer().mul( value_, other.value_ );
+     return *this;
+}
+
+
+Galois64& Galois64::operator/= ( const Galois64& other )
+{
+     if ( !( *this ) )
+     {
+          return *this;
+     }
+     if ( other && field_ != other.field_ )
+     {
+          throw std::runtime_error{ "operands are from different fields" };
+     }
+     return *this *= other.inv();
+}
+
+
+Galois64 Galois64::operator- () const
+{
+     return *this;
+}
+
+
+bool Galois64::operator== ( const Galois64& other ) const
+{
+     if ( !( *this ) && !other )
+     {
+          return true;
+     }
+     return field_ == other.field_ && value_ == other.value_;
+}
+
+
+bool Galois64::operator!= ( const Galois64& other ) const
+{
+     return !( *this == other );
+}
+
+
+bool Galois64::operator> ( const Galois64& other ) const
+{
+     if ( !( *this ) )
+     {
+          return false;
+     }
+     if ( !other )
+     {
+          return true;
+     }
+     if ( field_ != other.field_ )
+     {
+          throw std::runtime_error{ "operands are from different fields" };
+     }
+     return value_ > other.value_;
+}
+
+
+bool Galois64::operator< ( const Galois64& other ) const
+{
+     return ( *this != other ) && !( *this > other );
+}
+
+
+bool Galois64::operator>= ( const Galois64& other ) const
+{
+     return ( *this == other ) || ( *this > other );
+}
+
+
+bool Galois64::operator<= ( const Galois64& other ) const
+{
+     return !( *this > other );
+}
+
+
+Galois64::operator bool() const
+{
+     return value_ != 0;
+}
+
+
+Galois64 Galois64::inv() const
+{
+     if ( !( *this ) )
+     {
+          throw std::runtime_error{ "division by zero" };
+     }
+     return Galois64{ field_, field_->reducer().inv( value_ ) };
+}
+
+
+const Galois2NField* Galois64::field() const
+{
+     return field_;
+}
+
+
+uint64_t Galois64::coeffs() const
+{
+     return value_;
+}
+
+
+Galois2N Galois64::to_galois_2n() const
+{
+     if ( !field_ )
+     {
+          return Galois2N{};
+     }
+     return Galois2N{ field_, polynom_type( field_->degree(), value_ ) };
+}
+
+
+const Galois2NField* Galois64::make_field( const polynom_type& irreducible )
+{
+     const Galois2NField* field = Galois2NField::get( irreducible );
+     if ( field && !field->is_word() )
+     {
+          throw std::runtime_error{ "field degree must be in [1, 64]" };
+     }
+     return field;
+}
+
+
+bool Galois64::check_field( const Galois64& other )
+{
+     if ( !other )
+     {
+          return false;
+     }
+     if ( !( *this ) )
+     {
+          field_ = other.field_;
+          value_ = 0;
+     }
+     if ( field_ != other.field_ )
+     {
+          throw std::runtime_error{ "operands are from different fields" };
+     }
+     return true;
+}
+
+Galois64 operator+ ( Galois64 a, const Galois64& b ) { return a += b; }
+Galois64 operator- ( Galois64 a, const Galois64& b ) { return a += b; }
+Galois64 operator* ( Galois64 a, const Galois64& b ) { return a *= b; }
+Galois64 operator/ ( Galois64 a, const Galois64& b ) { return a /= b; }
+
+
+Galois64 pow( const Galois64& base, size_t exp )
+{
+     if ( !base )
+     {
+          return base;
+     }
+     return Galois64{ base.field(), base.field()->reducer().pow( base.coeffs(), exp ) };
+}
@@ -0,0 +1,256 @@
+#include <sets/galois_batch.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr size_t tile = Galois2NBatch::tile_words;
+
+
+// the kernels are compiled for AVX-512, AVX2 and the generic target and
+// picked at load time; their inner loops over one tile are vectorized
+
+__attribute__(( target_clones( "avx512f", "avx2", "default" ) ))
+void xor_planes( uint64_t* dst, const uint64_t* src, size_t n )
+{
+     for ( size_t i = 0; i < n; i++ )
+     {
+          dst[ i ] ^= src[ i ];
+     }
+}
+
+
+// wide = a * b for one tile, a and b are planes with the given stride,
+// wide has 2 * degree - 1 planes of tile words
+__attribute__(( target_clones( "avx512f", "avx2", "default" ) ))
+void mul_tile( uint64_t* wide, const uint64_t* a, const uint64_t* b, size_t stride, size_t degree )
+{
+     std::fill( wide, wide + ( 2 * degree - 1 ) * tile, 0 );
+     for ( size_t i = 0; i < degree; i++ )
+     {
+          const uint64_t* a_plane = a + i * stride;
+          for ( size_t j = 0; j < degree; j++ )
+          {
+               const uint64_t* b_plane = b + j * stride;
+               uint64_t* w_plane = wide + ( i + j ) * tile;
+               for ( size_t t = 0; t < tile; t++ )
+               {
+                    w_plane[ t ] ^= a_plane[ t ] & b_plane[ t ];
+               }
+          }
+     }
+}
+
+
+// x^degree = sum of x^tap: planes above the degree fold from the top
+// into the lower ones, the result goes to dst planes with the given stride
+__attribute__(( target_clones( "avx512f", "avx2", "default" ) ))
+void reduce_tile( uint64_t* dst, size_t stride, uint64_t* wide, size_t degree,
+                  const size_t* taps, size_t tap_count )
+{
+     for ( size_t k = 2 * degree - 1; k-- > degree; )
+     {
+          const uint64_t* high = wide + k * tile;
+          for ( size_t i = 0; i < tap_count; i++ )
+          {
+               uint64_t* low = wide + ( k - degree + taps[ i ] ) * tile;
+               for ( size_t t = 0; t < tile; t++ )
+               {
+                    low[ t ] ^= high[ t ];
+               }
+          }
+     }
+     for ( size_t i = 0; i < degree; i++ )
+     {
+          std::copy( wide + i * tile, wide + ( i + 1 ) * tile, dst + i * stride );
+     }
+}
+
+
+std::vector< size_t > taps_of( const Galois2NField& field )
+{
+     std::vector< size_t > taps;
+     const auto& pol = field.irreducible_pol();
+     for ( size_t i = 0; i < field.degree(); i++ )
+     {
+          if ( pol.test( i ) )
+          {
+               taps.push_back( i );
+          }
+     }
+     return taps;
+}
+
+} // namespace
+
+
+Galois2NBatch::Galois2NBatch( const Galois2NField* field, size_t size ):
+     field_{ field }, size_{ size }, groups_{ ( size + 64 * tile - 1 ) / ( 64 * tile ) * tile }
+{
+     planes_.assign( degree() * groups_, 0 );
+}
+
+
+Galois2NBatch::Galois2NBatch( const std::vector< Galois2N >& elems ):
+     Galois2NBatch{ nullptr, elems.size() }
+{
+     for ( const auto& elem : elems )
+     {
+          if ( elem )
+          {
+               *this = Galois2NBatch{ elem.field(), elems.size() };
+               break;
+          }
+     }
+     for ( size_t i = 0; i < elems.size(); i++ )
+     {
+          set( i, elems[ i ] );
+     }
+}
+
+
+Galois2NBatch& Galois2NBatch::operator+= ( const Galois2NBatch& other )
+{
+     check_compatible( other );
+     if ( !other.field_ )
+     {
+          return *this;
+     }
+     if ( !field_ )
+     {
+          return *this = other;
+     }
+     xor_planes( planes_.data(), other.planes_.data(), planes_.size() );
+     return *this;
+}
+
+
+Galois2NBatch& Galois2NBatch::operator-= ( const Galois2NBatch& other )
+{
+     return *this += other;
+}
+
+
+Galois2NBatch& Galois2NBatch::operator*= ( const Galois2NBatch& other )
+{
+     check_compatible( other );
+     if ( !degree() || !other.degree() )
+     {
+          return *this = Galois2NBatch{ nullptr, size_ };
+     }
+     auto taps = taps_of( *field_ );
+     std::vector< uint64_t > wide( ( 2 * degree() - 1 ) * tile );
+     for ( size_t g = 0; g < groups_; g += tile )
+     {
+          mul_tile( wide.data(), planes_.data() + g, other.planes_.data() + g, groups_, degree() );
+          reduce_tile( planes_.data() + g, groups_, wide.data(), degree(), taps.data(), taps.size() );
+     }
+     return *this;
+}
+
+
+// squaring is linear over GF(2): bit i moves to x^2i, then the reduction
+Galois2NBatch& Galois2NBatch::square()
+{
+     if ( !degree() )
+     {
+          return *this;
+     }
+     auto taps = taps_of( *field_ );
+     std::vector< uint64_t > wide( ( 2 * degree() - 1 ) * tile );
+     for ( size_t g = 0; g < groups_; g += tile )
+     {
+          std::fill( wide.begin(), wide.end(), 0 );
+          for ( size_t i = 0; i < degree(); i++ )
+          {
+               const uint64_t* plane = planes_.data() + i * groups_ + g;
+               std::copy( plane, plane + tile, wide.data() + 2 * i * tile );
+          }
+          reduce_tile( planes_.data() + g, groups_, wide.data(), degree(), taps.data(), taps.size() );
+     }
+     return *this;
+}
+
+
+size_t Galois2NBatch::size() const
+{
+     return size_;
+}
+
+
+const Galois2NField* Galois2NBatch::field() const
+{
+     return field_;
+}
+
+
+Galois2N Galois2NBatch::get( size_t i ) const
+{
+     if ( i >= size_ )
+     {
+          throw std::out_of_range{ "batch index out of range" };
+     }
+     Galois2N::polynom_type coeffs( degree() );
+     for ( size_t k = 0; k < degree(); k++ )
+     {
+          coeffs[ k ] = ( planes_[ k * groups_ + i / 64 ] >> ( i % 64 ) ) & 1;
+     }
+     return Galois2N{ field_, coeffs };
+}
+
+
+void Galois2NBatch::set( size_t i, const Galois2N& value )
+{
+     if ( i >= size_ )
+     {
+          throw std::out_of_range{ "batch index out of range" };
+     }
+     if ( value && value.field() != field_ )
+     {
+          throw std::runtime_error{ "operands are from different fields" };
+     }
+     const auto& coeffs = value.coeffs();
+     for ( size_t k = 0; k < degree(); k++ )
+     {
+          uint64_t& word = planes_[ k * groups_ + i / 64 ];
+          uint64_t bit = uint64_t{ 1 } << ( i % 64 );
+          word = ( value && coeffs.test( k ) ) ? ( word | bit ) : ( word & ~bit );
+     }
+}
+
+
+std::vector< Galois2N > Galois2NBatch::to_elements() const
+{
+     std::vector< Galois2N > elems;
+     elems.reserve( size_ );
+     for ( size_t i = 0; i < size_; i++ )
+     {
+          elems.push_back( get( i ) );
+     }
+     return elems;
+}
+
+
+size_t Galois2NBatch::degree() const
+{
+     return field_ ? field_->degree() : 0;
+}
+
+
+void Galois2NBatch::check_compatible( const Galois2NBatch& other ) const
+{
+     if ( size_ != other.size_ )
+     {
+          throw std::runtime_error{ "different batch sizes" };
+     }
+     if ( field_ && other.field_ && field_ != other.field_ )
+     {
+          throw std::runtime_error{ "operands are from different fields" };
+     }
+}
+
+Galois2NBatch operator+ ( Galois2NBatch a, const Galois2NBatch& b ) { return a += b; }
+Galois2NBatch operator- ( Galois2NBatch a, const Galois2NBatch& b ) { return a += b; }
+Galois2NBatch operator* ( Galois2NBatch a, const Galois2NBatch& b ) { return a *= b; }
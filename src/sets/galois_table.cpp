@@ -0,0 +1,71 @@
+#include <sets/galois_table.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+
+// one slot per field polynomial, a slot is filled once outside the
+// registry lock, so building a table does not block other fields
+struct TableSlot
+{
+     std::once_flag once;
+     std::unique_ptr< GaloisTable > table;
+};
+
+} // namespace
+
+
+const GaloisTable* GaloisTable::get( size_t degree, uint64_t poly )
+{
+     if ( degree == 0 || degree > max_degree )
+     {
+          return nullptr;
+     }
+     poly &= ( uint64_t{ 1 } << degree ) - 1;
+     static std::map< std::pair< size_t, uint64_t >, TableSlot > registry;
+     static std::mutex mutex;
+     TableSlot* slot;
+     {
+          std::lock_guard< std::mutex > lock{ mutex };
+          slot = &registry[ { degree, poly } ];
+     }
+     std::call_once( slot->once, [ & ]()
+     {
+          auto table = std::make_unique< GaloisTable >();
+          if ( table->build( degree, poly ) )
+          {
+               slot->table = std::move( table );
+          }
+     } );
+     return slot->table.get();
+}
+
+
+// walks the powers of a, fails unless they cycle through the whole group
+bool GaloisTable::build( size_t degree, uint64_t poly )
+{
+     size_t order = ( size_t{ 1 } << degree ) - 1;
+     uint32_t top = uint32_t{ 1 } << degree;
+     log_.assign( order + 1, 0 );
+     exp_.assign( 2 * order, 0 );
+     uint32_t value = 1;
+     for ( size_t i = 0; i < order; i++ )
+     {
+          if ( value == 1 && i > 0 )
+          {
+               return false;
+          }
+          exp_[ i ] = exp_[ i + order ] = static_cast< uint16_t >( value );
+          log_[ value ] = static_cast< uint16_t >( i );
+          value <<= 1;
+          if ( value & top )
+          {
+               value ^= top | static_cast< uint32_t >( poly );
+          }
+     }
+     return value == 1;
+}
@@ -0,0 +1,261 @@
+#include <sets/gf2_polynomials.h>
+#include <sets/gf2_reducer.h>
+#include <sets/gf2_wide_reducer.h>
+#include <sets/primality.h>
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+using polynom_type = boost::dynamic_bitset< uint64_t >;
+
+
+struct PolynomSlot
+{
+     std::once_flag once;
+     polynom_type pol;
+};
+
+
+// index of the highest set bit plus one, 0 for the zero polynomial
+size_t top_of( const std::vector< uint64_t >& a )
+{
+     for ( size_t k = a.size(); k-- > 0; )
+     {
+          if ( a[ k ] )
+          {
+               return 64 * k + 64 - __builtin_clzll( a[ k ] );
+          }
+     }
+     return 0;
+}
+
+
+// a ^= b << shift, bits past the size of a are dropped
+void xor_shifted( std::vector< uint64_t >& a, const std::vector< uint64_t >& b, size_t shift )
+{
+     size_t words = shift / 64, bits = shift % 64;
+     for ( size_t j = 0; j + words < a.size() && j < b.size(); j++ )
+     {
+          a[ j + words ] ^= b[ j ] << bits;
+          if ( bits && j + words + 1 < a.size() )
+          {
+               a[ j + words + 1 ] ^= b[ j ] >> ( 64 - bits );
+          }
+     }
+}
+
+
+// gcd( a, b ) = 1 by Euclid's algorithm with shift-and-xor division
+bool coprime( std::vector< uint64_t > a, std::vector< uint64_t > b )
+{
+     for ( ;; )
+     {
+          size_t top_a = top_of( a ), top_b = top_of( b );
+          if ( top_b == 0 )
+          {
+               return top_a == 1;
+          }
+          if ( top_a < top_b )
+          {
+               std::swap( a, b );
+               continue;
+          }
+          xor_shifted( a, b, top_a - top_b );
+     }
+}
+
+
+std::vector< uint64_t > words_of( const polynom_type& pol, size_t degree )
+{
+     std::vector< uint64_t > words( pol.num_blocks() );
+     boost::to_block_range( pol, words.begin() );
+     words.resize( degree / 64 + 1, 0 );
+     return words;
+}
+
+
+// degree of pol, npos for the zero polynomial
+size_t degree_of( const polynom_type& pol )
+{
+     size_t degree = polynom_type::npos;
+     for ( size_t i = pol.find_first(); i != polynom_type::npos; i = pol.find_next( i ) )
+     {
+          degree = i;
+     }
+     return degree;
+}
+
+
+// next set of exponents 1 <= c[ 0 ] < ... < c[ m - 1 ] < limit, ordered
+// by the highest exponent first; false after the last one
+bool next_exponents( std::vector< size_t >& c, size_t limit )
+{
+     for ( size_t i = 0; i < c.size(); i++ )
+     {
+          size_t bound = ( i + 1 < c.size() ) ? c[ i + 1 ] : limit;
+          if ( c[ i ] + 1 < bound )
+          {
+               c[ i ]++;
+               for ( size_t j = 0; j < i; j++ )
+               {
+                    c[ j ] = j + 1;
+               }
+               return true;
+          }
+     }
+     return false;
+}
+
+
+// polynomials with an even number of terms vanish at 1, so only
+// x^n + 1 and odd weights can be irreducible
+polynom_type lowest_weight( size_t degree, bool ( *accept )( const polynom_type& ) )
+{
+     if ( degree == 0 )
+     {
+          throw std::runtime_error{ "field polynomial of degree 0" };
+     }
+     for ( size_t middle = 0; middle < degree; middle += ( middle == 0 ) ? 1 : 2 )
+     {
+          std::vector< size_t > exponents( middle );
+          for ( size_t i = 0; i < middle; i++ )
+          {
+               exponents[ i ] = i + 1;
+          }
+          do
+          {
+               polynom_type pol( degree + 1 );
+               pol.set( degree );
+               pol.set( 0 );
+               for ( size_t e : exponents )
+               {
+                    pol.set( e );
+               }
+               if ( accept( pol ) )
+               {
+                    return pol;
+               }
+          } while ( next_exponents( exponents, degree ) );
+     }
+     throw std::runtime_error{ "no field polynomial found" };
+}
+
+
+const polynom_type& cached( std::map< size_t, PolynomSlot >& registry, std::mutex& mutex,
+                            size_t degree, bool ( *accept )( const polynom_type& ) )
+{
+     PolynomSlot* slot;
+     {
+          std::lock_guard< std::mutex > lock{ mutex };
+          slot = &registry[ degree ];
+     }
+     std::call_once( slot->once, [ & ]()
+     {
+          slot->pol = lowest_weight( degree, accept );
+     } );
+     return slot->pol;
+}
+
+} // namespace
+
+
+bool is_irreducible( const polynom_type& pol )
+{
+     size_t degree = degree_of( pol );
+     if ( degree == polynom_type::npos || degree == 0 )
+     {
+          return false;
+     }
+     if ( degree == 1 )
+     {
+          return true;
+     }
+     if ( !pol.test( 0 ) )
+     {
+          return false;     // divisible by x
+     }
+     auto f = words_of( pol, degree );
+     Gf2WideReducer red{ degree, f };
+     std::vector< uint64_t > x( red.words(), 0 ), power( red.words(), 0 ), wide( 2 * red.words() );
+     x[ 0 ] = power[ 0 ] = 2;
+     // x^2^( n / q ) for the prime divisors q of n, in the order of squarings
+     std::map< size_t, std::vector< uint64_t > > checks;
+     for ( const auto& factor : factorize( degree ) )
+     {
+          checks[ degree / factor.first ];
+     }
+     for ( size_t k = 1; k <= degree; k++ )
+     {
+          red.sqr( power.data(), power.data(), wide.data() );
+          auto check = checks.find( k );
+          if ( check != checks.end() )
+          {
+               check->second = power;
+          }
+     }
+     if ( power != x )
+     {
+          return false;
+     }
+     for ( auto& check : checks )
+     {
+          auto& g = check.second;
+          g[ 0 ] ^= 2;
+          g.resize( f.size(), 0 );
+          if ( !coprime( g, f ) )
+          {
+               return false;
+          }
+     }
+     return true;
+}
+
+
+// x^( ( 2^n - 1 ) / p ) != 1 for the prime divisors p of the group order
+bool is_primitive( const polynom_type& pol )
+{
+     size_t degree = degree_of( pol );
+     if ( degree != polynom_type::npos && degree > 64 )
+     {
+          throw std::runtime_error{ "primitivity test is limited to degree 64" };
+     }
+     if ( !is_irreducible( pol ) || !pol.test( 0 ) )
+     {
+          return false;
+     }
+     Gf2Reducer red{ degree, words_of( pol, degree )[ 0 ] };
+     uint64_t root = ( degree > 1 ) ? 2 : red.poly();
+     for ( const auto& factor : factorize( red.mask() ) )
+     {
+          if ( red.pow( root, red.mask() / factor.first ) == 1 )
+          {
+               return false;
+          }
+     }
+     return true;
+}
+
+
+const polynom_type& irreducible_polynom( size_t degree )
+{
+     static std::map< size_t, PolynomSlot > registry;
+     static std::mutex mutex;
+     return cached( registry, mutex, degree, is_irreducible );
+}
+
+
+const polynom_type& primitive_polynom( size_t degree )
+{
+     if ( degree > 64 )
+     {
+          throw std::runtime_error{ "primitivity test is limited to degree 64" };
+     }
+     static std::map< size_t, PolynomSlot > registry;
+     static std::mutex mutex;
+     return cached( registry, mutex, degree, is_primitive );
+}
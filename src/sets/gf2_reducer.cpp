@@ -0,0 +1,165 @@
+#include <sets/gf2_reducer.h>
+
+#include <immintrin.h>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+using wide_type = Gf2Reducer::wide_type;
+
+
+bool has_pclmul()
+{
+     static const bool supported = ( __builtin_cpu_init(), __builtin_cpu_supports( "pclmul" ) );
+     return supported;
+}
+
+
+// four bits of b per step against a table of a * { 0 .. 15 }
+wide_type clmul_portable( uint64_t a, uint64_t b )
+{
+     wide_type table[ 16 ];
+     table[ 0 ] = 0;
+     table[ 1 ] = a;
+     for ( size_t i = 2; i < 16; i += 2 )
+     {
+          table[ i ] = table[ i / 2 ] << 1;
+          table[ i + 1 ] = table[ i ] ^ a;
+     }
+     wide_type result = 0;
+     for ( int shift = 60; shift >= 0; shift -= 4 )
+     {
+          result = ( result << 4 ) ^ table[ ( b >> shift ) & 15 ];
+     }
+     return result;
+}
+
+
+__attribute__(( target( "pclmul" ) ))
+inline wide_type clmul_pclmul( uint64_t a, uint64_t b )
+{
+     __m128i product = _mm_clmulepi64_si128( _mm_cvtsi64_si128( a ), _mm_cvtsi64_si128( b ), 0 );
+     uint64_t lo = _mm_cvtsi128_si64( product );
+     uint64_t hi = _mm_cvtsi128_si64( _mm_unpackhi_epi64( product, product ) );
+     return ( static_cast< wide_type >( hi ) << 64 ) | lo;
+}
+
+
+// Barrett: for c = c1 * x^n + c0 the quotient by f is
+// c1 + ( c1 * mu_low ) / x^n and the remainder c0 + q * poly mod x^n
+uint64_t reduce_portable( const Gf2Reducer& f, wide_type c )
+{
+     uint64_t c1 = static_cast< uint64_t >( c >> f.degree() );
+     uint64_t q = c1 ^ static_cast< uint64_t >( clmul_portable( c1, f.mu() ) >> f.degree() );
+     return ( static_cast< uint64_t >( c ) ^ static_cast< uint64_t >( clmul_portable( q, f.poly() ) ) ) & f.mask();
+}
+
+
+__attribute__(( target( "pclmul" ) ))
+inline uint64_t reduce_pclmul( const Gf2Reducer& f, wide_type c )
+{
+     uint64_t c1 = static_cast< uint64_t >( c >> f.degree() );
+     uint64_t q = c1 ^ static_cast< uint64_t >( clmul_pclmul( c1, f.mu() ) >> f.degree() );
+     return ( static_cast< uint64_t >( c ) ^ static_cast< uint64_t >( clmul_pclmul( q, f.poly() ) ) ) & f.mask();
+}
+
+
+__attribute__(( target( "pclmul" ) ))
+uint64_t mul_pclmul( const Gf2Reducer& f, uint64_t a, uint64_t b )
+{
+     return reduce_pclmul( f, clmul_pclmul( a, b ) );
+}
+
+
+int degree_of( wide_type a )
+{
+     uint64_t hi = static_cast< uint64_t >( a >> 64 );
+     if ( hi )
+     {
+          return 127 - __builtin_clzll( hi );
+     }
+     uint64_t lo = static_cast< uint64_t >( a );
+     return lo ? 63 - __builtin_clzll( lo ) : -1;
+}
+
+} // namespace
+
+
+wide_type clmul( uint64_t a, uint64_t b )
+{
+     return has_pclmul() ? clmul_pclmul( a, b ) : clmul_portable( a, b );
+}
+
+
+uint64_t Gf2Reducer::mul( uint64_t a, uint64_t b ) const
+{
+     if ( has_pclmul() )
+     {
+          return mul_pclmul( *this, a, b );
+     }
+     return reduce_portable( *this, clmul_portable( a, b ) );
+}
+
+
+uint64_t Gf2Reducer::sqr( uint64_t a ) const
+{
+     return mul( a, a );
+}
+
+
+uint64_t Gf2Reducer::reduce( wide_type a ) const
+{
+     return has_pclmul() ? reduce_pclmul( *this, a ) : reduce_portable( *this, a );
+}
+
+
+// extended euclidean algorithm on words, f needs degree + 1 bits;
+// invariant r0 = t0 * a and r1 = t1 * a modulo f
+uint64_t Gf2Reducer::inv( uint64_t a ) const
+{
+     wide_type r0 = ( wide_type{ 1 } << degree_ ) | poly_, r1 = a & mask_;
+     wide_type t0 = 0, t1 = 1;
+     while ( r1 != 0 )
+     {
+          int shift = degree_of( r0 ) - degree_of( r1 );
+          if ( shift < 0 )
+          {
+               std::swap( r0, r1 );
+               std::swap( t0, t1 );
+               shift = -shift;
+          }
+          r0 ^= r1 << shift;
+          t0 ^= t1 << shift;
+          if ( degree_of( r0 ) < degree_of( r1 ) )
+          {
+               std::swap( r0, r1 );
+               std::swap( t0, t1 );
+          }
+     }
+     if ( r0 != 1 )
+     {
+          throw std::runtime_error{ "not invertible element" };
+     }
+     return static_cast< uint64_t >( t0 ) & mask_;
+}
+
+
+uint64_t Gf2Reducer::pow( uint64_t a, uint64_t exp ) const
+{
+     uint64_t result = 1 & mask_, square = a;
+     while ( exp )
+     {
+          if ( exp & 1 )
+          {
+               result = mul( result, square );
+          }
+          exp >>= 1;
+          if ( exp )
+          {
+               square = sqr( square );
+          }
+     }
+     return result;
+}
@@ -0,0 +1,288 @@
+#include <sets/gf2_wide_reducer.h>
+#include <sets/gf2_reducer.h>
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+
+using wide_type = Gf2Reducer::wide_type;
+
+
+// squaring table: byte b spread to 16 bits with zeroes between its bits,
+// squaring is linear over GF(2), so ( sum x^i )^2 = sum x^2i
+constexpr std::array< uint16_t, 256 > make_square_table()
+{
+     std::array< uint16_t, 256 > table{};
+     for ( size_t b = 0; b < 256; b++ )
+     {
+          for ( size_t i = 0; i < 8; i++ )
+          {
+               table[ b ] |= ( ( b >> i ) & 1 ) << ( 2 * i );
+          }
+     }
+     return table;
+}
+
+
+constexpr auto square_table = make_square_table();
+
+
+// lower half of a word squared
+uint64_t spread( uint32_t half )
+{
+     uint64_t result = 0;
+     for ( size_t i = 0; i < 4; i++ )
+     {
+          result |= static_cast< uint64_t >( square_table[ ( half >> ( 8 * i ) ) & 0xff ] ) << ( 16 * i );
+     }
+     return result;
+}
+
+
+// width <= 64 bits of a starting at bit pos
+uint64_t get_bits( const uint64_t* a, size_t size, size_t pos, size_t width )
+{
+     size_t word = pos / 64, shift = pos % 64;
+     uint64_t result = a[ word ] >> shift;
+     if ( shift && word + 1 < size )
+     {
+          result |= a[ word + 1 ] << ( 64 - shift );
+     }
+     return ( width == 64 ) ? result : result & ( ( uint64_t{ 1 } << width ) - 1 );
+}
+
+
+// a ^= value << pos, bits past size words must be zero in value
+void xor_bits( uint64_t* a, size_t size, size_t pos, wide_type value )
+{
+     size_t word = pos / 64, shift = pos % 64;
+     uint64_t lo = static_cast< uint64_t >( value ), hi = static_cast< uint64_t >( value >> 64 );
+     uint64_t parts[ 3 ] = { lo, hi, 0 };
+     if ( shift )
+     {
+          parts[ 0 ] = lo << shift;
+          parts[ 1 ] = ( hi << shift ) | ( lo >> ( 64 - shift ) );
+          parts[ 2 ] = hi >> ( 64 - shift );
+     }
+     for ( size_t i = 0; i < 3 && word + i < size; i++ )
+     {
+          a[ word + i ] ^= parts[ i ];
+     }
+}
+
+
+// a ^= value << pos, the bits of value land in words below size
+void xor_word( uint64_t* a, size_t pos, uint64_t value )
+{
+     size_t word = pos / 64, shift = pos % 64;
+     a[ word ] ^= value << shift;
+     if ( shift )
+     {
+          a[ word + 1 ] ^= value >> ( 64 - shift );
+     }
+}
+
+} // namespace
+
+
+Gf2WideReducer::Gf2WideReducer( size_t degree, std::vector< uint64_t > poly ):
+     degree_{ degree }, words_{ ( degree + 63 ) / 64 }, poly_{ std::move( poly ) }
+{
+     poly_.resize( words_, 0 );
+     if ( degree_ % 64 )
+     {
+          poly_.back() &= ( uint64_t{ 1 } << ( degree_ % 64 ) ) - 1;
+     }
+     size_t poly_degree = 0;     // plus one
+     for ( size_t k = words_; k-- > 0; )
+     {
+          if ( poly_[ k ] )
+          {
+               poly_degree = 64 * k + 64 - __builtin_clzll( poly_[ k ] );
+               break;
+          }
+     }
+     chunk_ = std::min< size_t >( 64, degree_ + 1 - poly_degree );
+     // f = x^degree + x^a + x^b + x^c + 1 with a word of room under x^degree,
+     // as in the NIST fields, folds a word at a time with shifts and XORs
+     for ( size_t i = 0; i < poly_degree; i++ )
+     {
+          if ( ( poly_[ i / 64 ] >> ( i % 64 ) ) & 1 )
+          {
+               taps_.push_back( i );
+          }
+     }
+     if ( taps_.size() > 4 || poly_degree + 63 > degree_ )
+     {
+          taps_.clear();
+     }
+}
+
+
+size_t Gf2WideReducer::degree() const
+{
+     return degree_;
+}
+
+
+size_t Gf2WideReducer::words() const
+{
+     return words_;
+}
+
+
+void Gf2WideReducer::mul( uint64_t* dst, const uint64_t* a, const uint64_t* b, uint64_t* wide ) const
+{
+     std::fill( wide, wide + 2 * words_, 0 );
+     for ( size_t i = 0; i < words_; i++ )
+     {
+          if ( !a[ i ] )
+          {
+               continue;
+          }
+          for ( size_t j = 0; j < words_; j++ )
+          {
+               wide_type product = clmul( a[ i ], b[ j ] );
+               wide[ i + j ] ^= static_cast< uint64_t >( product );
+               wide[ i + j + 1 ] ^= static_cast< uint64_t >( product >> 64 );
+          }
+     }
+     reduce( dst, wide );
+}
+
+
+void Gf2WideReducer::sqr( uint64_t* dst, const uint64_t* a, uint64_t* wide ) const
+{
+     for ( size_t i = words_; i-- > 0; )
+     {
+          uint64_t word = a[ i ];
+          wide[ 2 * i ] = spread( static_cast< uint32_t >( word ) );
+          wide[ 2 * i + 1 ] = spread( static_cast< uint32_t >( word >> 32 ) );
+     }
+     reduce( dst, wide );
+}
+
+
+// x^degree = poly: chunks of bits above the degree are folded down
+// from the top, each one is multiplied by poly with carry-less products
+void Gf2WideReducer::reduce( uint64_t* dst, uint64_t* wide ) const
+{
+     if ( !taps_.empty() )
+     {
+          reduce_sparse( dst, wide );
+          return;
+     }
+     size_t size = 2 * words_;
+     for ( size_t top = 2 * degree_ - 1; top > degree_; )
+     {
+          size_t width = std::min( chunk_, top - degree_ );
+          size_t pos = top - width;
+          uint64_t chunk = get_bits( wide, size, pos, width );
+          if ( chunk )
+          {
+               xor_bits( wide, size, pos, chunk );
+               for ( size_t k = 0; k < words_; k++ )
+               {
+                    if ( poly_[ k ] )
+                    {
+                         xor_bits( wide, size, pos - degree_ + 64 * k, clmul( chunk, poly_[ k ] ) );
+                    }
+               }
+          }
+          top = pos;
+     }
+     std::copy( wide, wide + words_, dst );
+     if ( degree_ % 64 )
+     {
+          dst[ words_ - 1 ] &= ( uint64_t{ 1 } << ( degree_ % 64 ) ) - 1;
+     }
+}
+
+
+// word i above the degree is x^( 64i - degree ) * sum x^tap, each tap
+// is at least a word below the degree, so the word lands below itself
+void Gf2WideReducer::reduce_sparse( uint64_t* dst, uint64_t* wide ) const
+{
+     for ( size_t i = 2 * words_; i-- > words_; )
+     {
+          uint64_t word = wide[ i ];
+          if ( word )
+          {
+               size_t pos = 64 * i - degree_;
+               for ( size_t tap : taps_ )
+               {
+                    xor_word( wide, pos + tap, word );
+               }
+          }
+     }
+     if ( degree_ % 64 )
+     {
+          uint64_t word = wide[ words_ - 1 ] >> ( degree_ % 64 );
+          wide[ words_ - 1 ] &= ( uint64_t{ 1 } << ( degree_ % 64 ) ) - 1;
+          for ( size_t tap : taps_ )
+          {
+               xor_word( wide, tap, word );
+          }
+     }
+     std::copy( wide, wide + words_, dst );
+}
+
+
+// addition chain over k in beta_k = a^( 2^k - 1 ):
+// beta_2k = beta_k^( 2^k ) * beta_k and beta_k+1 = beta_k^2 * a
+void Gf2WideReducer::inv( uint64_t* dst, const uint64_t* a ) const
+{
+     if ( degree_ == 1 )     // GF(2)
+     {
+          dst[ 0 ] = 1;
+          return;
+     }
+     // per-thread buffers, reused by later calls
+     thread_local std::vector< uint64_t > beta, power, wide;
+     beta.assign( a, a + words_ );
+     power.resize( words_ );
+     wide.resize( 2 * words_ );
+     size_t target = degree_ - 1, k = 1;
+     for ( size_t bit = 63 - __builtin_clzll( target ); bit-- > 0; )
+     {
+          std::copy( beta.begin(), beta.end(), power.begin() );
+          for ( size_t i = 0; i < k; i++ )
+          {
+               sqr( power.data(), power.data(), wide.data() );
+          }
+          mul( beta.data(), beta.data(), power.data(), wide.data() );
+          k *= 2;
+          if ( ( target >> bit ) & 1 )
+          {
+               sqr( beta.data(), beta.data(), wide.data() );
+               mul( beta.data(), beta.data(), a, wide.data() );
+               k++;
+          }
+     }
+     sqr( dst, beta.data(), wide.data() );
+}
+
+
+void Gf2WideReducer::pow( uint64_t* dst, const uint64_t* a, size_t exp ) const
+{
+     thread_local std::vector< uint64_t > result, square, wide;
+     result.assign( words_, 0 );
+     square.assign( a, a + words_ );
+     wide.resize( 2 * words_ );
+     result[ 0 ] = 1;
+     while ( exp )
+     {
+          if ( exp & 1 )
+          {
+               mul( result.data(), result.data(), square.data(), wide.data() );
+          }
+          exp >>= 1;
+          if ( exp )
+          {
+               sqr( square.data(), square.data(), wide.data() );
+          }
+     }
+     std::copy( result.begin(), result.end(), dst );
+}
@@ -0,0 +1,343 @@
+#include <sets/multi_modular.h>
+#include <sets/mod_reducer.h>
+#include <sets/residue.h>
+
+#include <array>
+#include <stdexcept>
+
+namespace
+{
+
+// largest primes below 2^62
+constexpr std::array< uint64_t, MultiModular::max_lanes > primes = {
+     4611686018427387847ull, 4611686018427387817ull, 4611686018427387787ull, 4611686018427387761ull,
+     4611686018427387751ull, 4611686018427387737ull, 4611686018427387733ull, 4611686018427387709ull,
+     4611686018427387701ull, 4611686018427387631ull, 4611686018427387617ull, 4611686018427387587ull,
+     4611686018427387461ull, 4611686018427387421ull, 4611686018427387409ull, 4611686018427387329ull
+};
+
+
+struct LaneTables
+{
+     LaneTables();
+
+     std::array< ModReducer, MultiModular::max_lanes > reducers;
+     // ( primes[ 0 ] * ... * primes[ i - 1 ] )^-1 mod primes[ i ], for Garner's algorithm
+     std::array< uint64_t, MultiModular::max_lanes > prefix_inv;
+};
+
+
+LaneTables::LaneTables()
+{
+     for ( size_t i = 0; i < primes.size(); i++ )
+     {
+          reducers[ i ] = ModReducer{ primes[ i ] };
+          uint64_t prefix = 1;
+          for ( size_t j = 0; j < i; j++ )
+          {
+               prefix = reducers[ i ].mul( prefix, primes[ j ] % primes[ i ] );
+          }
+          prefix_inv[ i ] = Residue{ primes[ i ], static_cast< int64_t >( prefix ) }.inv().get_value();
+     }
+}
+
+
+const LaneTables& tables()
+{
+     static const LaneTables instance;
+     return instance;
+}
+
+
+uint64_t reduce( const MultiModular::integer_type& value, uint64_t p )
+{
+     MultiModular::integer_type rem = value % p;
+     if ( rem < 0 )
+     {
+          rem += p;
+     }
+     return static_cast< uint64_t >( rem );
+}
+
+
+void check_lane_count( size_t lanes )
+{
+     if ( lanes > MultiModular::max_lanes )
+     {
+          throw std::runtime_error{ "too many lanes" };
+     }
+}
+
+} // namespace
+
+
+MultiModular::MultiModular( size_t lanes, int64_t value ):
+     MultiModular{ lanes, integer_type{ value } } {}
+
+
+MultiModular::MultiModular( size_t lanes, const integer_type& value )
+{
+     check_lane_count( lanes );
+     values_.resize( lanes );
+     for ( size_t i = 0; i < lanes; i++ )
+     {
+          values_[ i ] = reduce( value, primes[ i ] );
+     }
+}
+
+
+MultiModular::MultiModular( size_t lanes, const integer_type& num, const integer_type& den ):
+     MultiModular{ lanes, num }
+{
+     *this /= MultiModular{ lanes, den };
+}
+
+
+MultiModular& MultiModular::operator+= ( const MultiModular& other )
+{
+     if ( !check_lanes( other ) )
+     {
+          return *this;
+     }
+     const auto& red = tables().reducers;
+     for ( size_t i = 0; i < values_.size(); i++ )
+     {
+          values_[ i ] = red[ i ].add( values_[ i ], other.values_[ i ] );
+     }
+     return *this;
+}
+
+
+MultiModular& MultiModular::operator-= ( const MultiModular& other )
+{
+     if ( !check_lanes( other ) )
+     {
+          return *this;
+     }
+     const auto& red = tables().reducers;
+     for ( size_t i = 0; i < values_.size(); i++ )
+     {
+          values_[ i ] = red[ i ].sub( values_[ i ], other.values_[ i ] );
+     }
+     return *this;
+}
+
+
+MultiModular& MultiModular::operator*= ( const MultiModular& other )
+{
+     if ( !check_lanes( other ) )
+     {
+          values_.assign( values_.size(), 0 );
+          return *this;
+     }
+     const auto& red = tables().reducers;
+     for ( size_t i = 0; i < values_.size(); i++ )
+     {
+          values_[ i ] = red[ i ].mul( values_[ i ], other.values_[ i ] );
+     }
+     return *this;
+}
+
+
+MultiModular& MultiModular::operator/= ( const MultiModular& other )
+{
+     if ( !( *this ) )
+     {
+          return *this;
+     }
+     return *this *= other.inv();
+}
+
+
+MultiModular MultiModular::operator- () const
+{
+     auto ret{ *this };
+     const auto& red = tables().reducers;
+     for ( size_t i = 0; i < ret.values_.size(); i++ )
+     {
+          ret.values_[ i ] = red[ i ].neg( ret.values_[ i ] );
+     }
+     return ret;
+}
+
+
+bool MultiModular::operator== ( const MultiModular& other ) const
+{
+     if ( !( *this ) && !other )
+     {
+          return true;
+     }
+     return values_ == other.values_;
+}
+
+
+bool MultiModular::operator!= ( const MultiModular& other ) const
+{
+     return !( *this == other );
+}
+
+
+MultiModular::operator bool() const
+{
+     for ( auto value : values_ )
+     {
+          if ( value != 0 )
+          {
+               return true;
+          }
+     }
+     return false;
+}
+
+
+MultiModular MultiModular::inv() const
+{
+     if ( !( *this ) )
+     {
+          throw std::runtime_error{ "division by zero" };
+     }
+     MultiModular ret{ *this };
+     for ( size_t i = 0; i < values_.size(); i++ )
+     {
+          if ( values_[ i ] == 0 )
+          {
+               throw std::runtime_error{ "not invertible element" };   // divisible by a lane prime
+          }
+          ret.values_[ i ] = Residue{ primes[ i ], static_cast< int64_t >( values_[ i ] ) }.inv().get_value();
+     }
+     return ret;
+}
+
+
+size_t MultiModular::lanes() const
+{
+     return values_.size();
+}
+
+
+uint64_t MultiModular::lane( size_t i ) const
+{
+     return values_.at( i );
+}
+
+
+// Garner's algorithm: mixed radix digits c[ i ] in
+// x = c[ 0 ] + p0 * ( c[ 1 ] + p1 * ( c[ 2 ] + ... ) ) come from word
+// arithmetic only, the big integer is assembled once at the end
+MultiModular::integer_type MultiModular::to_integer() const
+{
+     const auto& tab = tables();
+     std::array< uint64_t, max_lanes > digits{};
+     for ( size_t i = 0; i < values_.size(); i++ )
+     {
+          const auto& red = tab.reducers[ i ];
+          uint64_t partial = 0;     // digits[ 0 .. i ) evaluated mod primes[ i ]
+          for ( size_t j = i; j-- > 0; )
+          {
+               partial = red.add( red.mul( partial, primes[ j ] % primes[ i ] ), digits[ j ] % primes[ i ] );
+          }
+          digits[ i ] = red.mul( red.sub( values_[ i ], partial ), tab.prefix_inv[ i ] );
+     }
+     integer_type result = 0;
+     for ( size_t i = values_.size(); i-- > 0; )
+     {
+          result = result * primes[ i ] + digits[ i ];
+     }
+     auto mod = modulus( values_.size() );
+     if ( result > mod / 2 )
+     {
+          result -= mod;
+     }
+     return result;
+}
+
+
+// half extended euclidean algorithm stopped at sqrt( M / 2 ),
+// the fraction with both parts below the bound is unique
+std::pair< MultiModular::integer_type, MultiModular::integer_type > MultiModular::to_rational() const
+{
+     auto mod = modulus( values_.size() );
+     auto value = to_integer();
+     if ( value < 0 )
+     {
+          value += mod;
+     }
+     integer_type bound = boost::multiprecision::sqrt( integer_type{ mod / 2 } );
+     integer_type r0 = mod, r1 = value, t0 = 0, t1 = 1;
+     while ( r1 > bound )
+     {
+          integer_type quotient = r0 / r1;
+          integer_type tmp = r0 - quotient * r1;
+          r0 = r1;
+          r1 = tmp;
+          tmp = t0 - quotient * t1;
+          t0 = t1;
+          t1 = tmp;
+     }
+     if ( t1 == 0 || boost::multiprecision::abs( t1 ) > bound || boost::multiprecision::gcd( r1, t1 ) != 1 )
+     {
+          throw std::runtime_error{ "rational reconstruction failed" };
+     }
+     if ( t1 < 0 )
+     {
+          return { -r1, -t1 };
+     }
+     return { r1, t1 };
+}
+
+
+uint64_t MultiModular::prime( size_t i )
+{
+     return primes.at( i );
+}
+
+
+MultiModular::integer_type MultiModular::modulus( size_t lanes )
+{
+     check_lane_count( lanes );
+     integer_type result = 1;
+     for ( size_t i = 0; i < lanes; i++ )
+     {
+          result *= primes[ i ];
+     }
+     return result;
+}
+
+
+bool MultiModular::check_lanes( const MultiModular& other )
+{
+     if ( other.values_.empty() )
+     {
+          return false;
+     }
+     if ( values_.empty() )
+     {
+          values_.assign( other.values_.size(), 0 );
+     }
+     if ( values_.size() != other.values_.size() )
+     {
+          throw std::runtime_error{ "different lane counts" };
+     }
+     return true;
+}
+
+MultiModular operator+ ( MultiModular a, const MultiModular& b ) { return a += b; }
+MultiModular operator- ( MultiModular a, const MultiModular& b ) { return a -= b; }
+MultiModular operator* ( MultiModular a, const MultiModular& b ) { return a *= b; }
+MultiModular operator/ ( MultiModular a, const MultiModular& b ) { return a /= b; }
+
+
+MultiModular pow( const MultiModular& base, size_t exp )
+{
+     MultiModular result{ base.lanes(), 1 }, square{ base };
+     while ( exp )
+     {
+          if ( exp & 1 )
+          {
+               result *= square;
+          }
+          square *= square;
+          exp >>= 1;
+     }
+     return result;
+}
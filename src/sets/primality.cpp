@@ -0,0 +1,182 @@
+#include <sets/primality.h>
+#include <sets/mod_reducer.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <numeric>
+
+namespace
+{
+
+// a^exp in the internal form of red
+uint64_t pow_form( const ModReducer& red, uint64_t a, uint64_t exp )
+{
+     uint64_t result = red.one_form();
+     while ( exp )
+     {
+          if ( exp & 1 )
+          {
+               result = red.mul_form( result, a );
+          }
+          a = red.mul_form( a, a );
+          exp >>= 1;
+     }
+     return result;
+}
+
+
+bool miller_rabin( uint64_t n )
+{
+     if ( n < 2 )
+     {
+          return false;
+     }
+     for ( uint64_t p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 } )
+     {
+          if ( n % p == 0 )
+          {
+               return n == p;
+          }
+     }
+     if ( n < 41 * 41 )
+     {
+          return true;
+     }
+     uint64_t d = n - 1;
+     size_t s = 0;
+     while ( !( d & 1 ) )
+     {
+          d >>= 1;
+          s++;
+     }
+     ModReducer red{ n };
+     const uint64_t one = red.one_form(), minus_one = red.neg( one );
+     // witnesses by Jim Sinclair, enough for all n < 2^64
+     for ( uint64_t a : { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 } )
+     {
+          a %= n;
+          if ( a == 0 )
+          {
+               continue;
+          }
+          uint64_t x = pow_form( red, red.to_form( a ), d );
+          if ( x == one || x == minus_one )
+          {
+               continue;
+          }
+          bool composite = true;
+          for ( size_t i = 1; i < s && composite; i++ )
+          {
+               x = red.mul_form( x, x );
+               composite = ( x != minus_one );
+          }
+          if ( composite )
+          {
+               return false;
+          }
+     }
+     return true;
+}
+
+
+// nontrivial factor of an odd composite n: Brent's cycle search on
+// x -> x^2 + c, gcds are taken once per batch of steps
+uint64_t rho_factor( uint64_t n )
+{
+     const size_t batch = 128;
+     ModReducer red{ n };
+     for ( uint64_t c = 1; ; c++ )
+     {
+          uint64_t c_form = red.to_form( c );
+          auto step = [ & ]( uint64_t x ) { return red.add( red.mul_form( x, x ), c_form ); };
+          // values stay in the Montgomery form, it keeps differences and gcds
+          uint64_t x = 0, y = red.to_form( 2 ), saved = y, product = red.one_form(), g = 1;
+          for ( size_t r = 1; g == 1; r <<= 1 )
+          {
+               x = y;
+               for ( size_t i = 0; i < r; i++ )
+               {
+                    y = step( y );
+               }
+               for ( size_t k = 0; k < r && g == 1; k += batch )
+               {
+                    saved = y;
+                    for ( size_t i = 0; i < batch && k + i < r; i++ )
+                    {
+                         y = step( y );
+                         product = red.mul_form( product, ( x > y ) ? x - y : y - x );
+                    }
+                    g = std::gcd( product, n );
+               }
+          }
+          if ( g == n )   // the batch overshot, repeat it one step at a time
+          {
+               do
+               {
+                    saved = step( saved );
+                    g = std::gcd( ( x > saved ) ? x - saved : saved - x, n );
+               } while ( g == 1 );
+          }
+          if ( g != n )
+          {
+               return g;
+          }
+     }
+}
+
+} // namespace
+
+
+bool is_prime( uint64_t n )
+{
+     // results for the last few numbers tested by this thread, callers
+     // recheck the same modulo in loops; misses replace round robin
+     const size_t slots = 4;
+     thread_local std::array< std::pair< uint64_t, bool >, slots > cached{};     // 0 is not prime
+     thread_local size_t next = 0;
+     for ( const auto& slot : cached )
+     {
+          if ( slot.first == n )
+          {
+               return slot.second;
+          }
+     }
+     bool result = miller_rabin( n );
+     cached[ next ] = { n, result };
+     next = ( next + 1 ) % slots;
+     return result;
+}
+
+
+std::vector< std::pair< uint64_t, size_t > > factorize( uint64_t n )
+{
+     std::map< uint64_t, size_t > factors;
+     for ( uint64_t p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 } )
+     {
+          while ( n % p == 0 )
+          {
+               factors[ p ]++;
+               n /= p;
+          }
+     }
+     std::vector< uint64_t > rest;
+     if ( n > 1 )
+     {
+          rest.push_back( n );
+     }
+     while ( !rest.empty() )
+     {
+          uint64_t m = rest.back();
+          rest.pop_back();
+          if ( is_prime( m ) )
+          {
+               factors[ m ]++;
+               continue;
+          }
+          uint64_t d = rho_factor( m );
+          rest.push_back( d );
+          rest.push_back( m / d );
+     }
+     return { factors.begin(), factors.end() };
+}
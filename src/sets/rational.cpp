@@ -0,0 +1,365 @@
+#include <sets/rational.h>
+
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+
+bool fits( const Rational::integer_type& value )
+{
+     return value > std::numeric_limits< int64_t >::min() && value <= std::numeric_limits< int64_t >::max();
+}
+
+
+// a * b + c * d without overflow and without INT64_MIN
+bool mul_add( int64_t a, int64_t b, int64_t c, int64_t d, int64_t& result )
+{
+     int64_t ab, cd;
+     return !__builtin_mul_overflow( a, b, &ab ) && !__builtin_mul_overflow( c, d, &cd ) &&
+            !__builtin_add_overflow( ab, cd, &result ) && result != std::numeric_limits< int64_t >::min();
+}
+
+
+// big rationals accept only positive denominators
+Rational::big_type make_big( const Rational::integer_type& num, const Rational::integer_type& den )
+{
+     if ( den < 0 )
+     {
+          return Rational::big_type{ Rational::integer_type{ -num }, Rational::integer_type{ -den } };
+     }
+     return Rational::big_type{ num, den };
+}
+
+
+bool mul( int64_t a, int64_t b, int64_t& result )
+{
+     return !__builtin_mul_overflow( a, b, &result ) && result != std::numeric_limits< int64_t >::min();
+}
+
+} // namespace
+
+
+Rational::Rational( int64_t num, int64_t den ):
+     num_{ num }, den_{ den }
+{
+     if ( den == 0 )
+     {
+          throw std::runtime_error{ "division by zero" };
+     }
+     if ( num == std::numeric_limits< int64_t >::min() || den == std::numeric_limits< int64_t >::min() )
+     {
+          set_big( make_big( num, den ) );
+     }
+     else if ( den < 0 )
+     {
+          num_ = -num_;
+          den_ = -den_;
+     }
+}
+
+
+Rational::Rational( const integer_type& num, const integer_type& den ):
+     num_{ 0 }, den_{ 1 }
+{
+     if ( den == 0 )
+     {
+          throw std::runtime_error{ "division by zero" };
+     }
+     set_big( make_big( num, den ) );
+}
+
+
+Rational::Rational( const Rational& other ):
+     num_{ other.num_ }, den_{ other.den_ },
+     big_{ other.big_ ? std::make_unique< big_type >( *other.big_ ) : nullptr } {}
+
+
+Rational::Rational( Rational&& other ) noexcept:
+     num_{ other.num_ }, den_{ other.den_ }, big_{ std::move( other.big_ ) } {}
+
+
+Rational& Rational::operator= ( const Rational& other )
+{
+     if ( &other != this )
+     {
+          num_ = other.num_;
+          den_ = other.den_;
+          big_ = other.big_ ? std::make_unique< big_type >( *other.big_ ) : nullptr;
+     }
+     return *this;
+}
+
+
+Rational& Rational::operator= ( Rational&& other ) noexcept
+{
+     if ( &other != this )
+     {
+          num_ = other.num_;
+          den_ = other.den_;
+          big_ = std::move( other.big_ );
+     }
+     return *this;
+}
+
+
+Rational& Rational::operator+= ( const Rational& other )
+{
+     if ( !big_ && !other.big_ && add_small( other.num_, other.den_ ) )
+     {
+          return *this;
+     }
+     set_big( to_big() + other.to_big() );
+     return *this;
+}
+
+
+Rational& Rational::operator-= ( const Rational& other )
+{
+     if ( !big_ && !other.big_ && add_small( -other.num_, other.den_ ) )
+     {
+          return *this;
+     }
+     set_big( to_big() - other.to_big() );
+     return *this;
+}
+
+
+Rational& Rational::operator*= ( const Rational& other )
+{
+     if ( !big_ && !other.big_ && mul_small( other.num_, other.den_ ) )
+     {
+          return *this;
+     }
+     set_big( to_big() * other.to_big() );
+     return *this;
+}
+
+
+Rational& Rational::operator/= ( const Rational& other )
+{
+     return *this *= other.inv();
+}
+
+
+Rational Rational::operator- () const
+{
+     Rational ret{ *this };
+     if ( ret.big_ )
+     {
+          *ret.big_ = -*ret.big_;
+     }
+     else
+     {
+          ret.num_ = -ret.num_;
+     }
+     return ret;
+}
+
+
+bool Rational::operator== ( const Rational& other ) const
+{
+     return compare( other ) == 0;
+}
+
+
+bool Rational::operator!= ( const Rational& other ) const
+{
+     return compare( other ) != 0;
+}
+
+
+bool Rational::operator< ( const Rational& other ) const
+{
+     return compare( other ) < 0;
+}
+
+
+bool Rational::operator> ( const Rational& other ) const
+{
+     return compare( other ) > 0;
+}
+
+
+bool Rational::operator<= ( const Rational& other ) const
+{
+     return compare( other ) <= 0;
+}
+
+
+bool Rational::operator>= ( const Rational& other ) const
+{
+     return compare( other ) >= 0;
+}
+
+
+Rational::operator bool() const
+{
+     return big_ ? *big_ != 0 : num_ != 0;
+}
+
+
+Rational Rational::inv() const
+{
+     if ( !( *this ) )
+     {
+          throw std::runtime_error{ "division by zero" };
+     }
+     if ( big_ )
+     {
+          Rational ret;
+          ret.set_big( 1 / *big_ );
+          return ret;
+     }
+     Rational ret;
+     ret.num_ = ( num_ < 0 ) ? -den_ : den_;
+     ret.den_ = ( num_ < 0 ) ? -num_ : num_;
+     return ret;
+}
+
+
+Rational::integer_type Rational::numerator() const
+{
+     return boost::multiprecision::numerator( to_big() );
+}
+
+
+Rational::integer_type Rational::denominator() const
+{
+     return boost::multiprecision::denominator( to_big() );
+}
+
+
+bool Rational::is_small() const
+{
+     return !big_;
+}
+
+
+void Rational::normalize()
+{
+     int64_t g = std::gcd( num_, den_ );
+     if ( g > 1 )
+     {
+          num_ /= g;
+          den_ /= g;
+     }
+}
+
+
+// num_ / den_ + num / den, first as is, then over the reduced common denominator
+bool Rational::add_small( int64_t num, int64_t den )
+{
+     int64_t res_num, res_den;
+     if ( mul_add( num_, den, num, den_, res_num ) && mul( den_, den, res_den ) )
+     {
+          num_ = res_num;
+          den_ = res_den;
+          return true;
+     }
+     normalize();
+     int64_t g = std::gcd( num, den );
+     num /= g;
+     den /= g;
+     g = std::gcd( den_, den );
+     if ( mul_add( num_, den / g, num, den_ / g, res_num ) && mul( den_, den / g, res_den ) )
+     {
+          num_ = res_num;
+          den_ = res_den;
+          normalize();
+          return true;
+     }
+     return false;
+}
+
+
+// num_ / den_ * num / den, first as is, then with cross cancellation
+bool Rational::mul_small( int64_t num, int64_t den )
+{
+     int64_t res_num, res_den;
+     if ( mul( num_, num, res_num ) && mul( den_, den, res_den ) )
+     {
+          num_ = res_num;
+          den_ = res_den;
+          return true;
+     }
+     int64_t g1 = std::gcd( num_, den ), g2 = std::gcd( num, den_ );
+     if ( mul( num_ / g1, num / g2, res_num ) && mul( den_ / g2, den / g1, res_den ) )
+     {
+          num_ = res_num;
+          den_ = res_den;
+          normalize();
+          return true;
+     }
+     return false;
+}
+
+
+Rational::big_type Rational::to_big() const
+{
+     if ( big_ )
+     {
+          return *big_;
+     }
+     return big_type{ integer_type{ num_ }, integer_type{ den_ } };
+}
+
+
+// the value goes back to machine words whenever it fits them
+void Rational::set_big( big_type value )
+{
+     const auto& num = boost::multiprecision::numerator( value );
+     const auto& den = boost::multiprecision::denominator( value );
+     if ( fits( num ) && fits( den ) )
+     {
+          num_ = static_cast< int64_t >( num );
+          den_ = static_cast< int64_t >( den );
+          big_.reset();
+     }
+     else if ( big_ )
+     {
+          *big_ = std::move( value );
+     }
+     else
+     {
+          big_ = std::make_unique< big_type >( std::move( value ) );
+     }
+}
+
+
+int Rational::compare( const Rational& other ) const
+{
+     if ( !big_ && !other.big_ )
+     {
+          using wide_type = __int128;
+          wide_type lhs = static_cast< wide_type >( num_ ) * other.den_;
+          wide_type rhs = static_cast< wide_type >( other.num_ ) * den_;
+          return ( lhs > rhs ) - ( lhs < rhs );
+     }
+     return to_big().compare( other.to_big() );
+}
+
+Rational operator+ ( Rational a, const Rational& b ) { return a += b; }
+Rational operator- ( Rational a, const Rational& b ) { return a -= b; }
+Rational operator* ( Rational a, const Rational& b ) { return a *= b; }
+Rational operator/ ( Rational a, const Rational& b ) { return a /= b; }
+
+
+Rational pow( const Rational& base, size_t exp )
+{
+     Rational result{ 1 }, square{ base };
+     while ( exp )
+     {
+          if ( exp & 1 )
+          {
+               result *= square;
+          }
+          exp >>= 1;
+          if ( exp )
+          {
+               square *= square;
+          }
+     }
+     return result;
+}
@@ -1,7 +1,120 @@
 #include <sets/residue.h>
+#include <sets/mod_reducer.h>
+#include <sets/primality.h>
 
 #include <stdexcept>
-#include <cmath>
+#include <algorithm>
+#include <array>
+
+namespace
+{
+
+// reduction engines of the last few moduli used by this thread, so
+// loops alternating between moduli (CRT, mixed polynomials) keep
+// theirs; the last hit is checked first, misses replace round robin
+const size_t reducer_slots = 4;
+
+
+const ModReducer& reducer( uint64_t modulo )
+{
+     thread_local std::array< ModReducer, reducer_slots > cached;
+     thread_local size_t last = 0, next = 0;
+     if ( cached[ last ].get_modulo() == modulo )
+     {
+          return cached[ last ];
+     }
+     for ( size_t i = 0; i < reducer_slots; i++ )
+     {
+          if ( cached[ i ].get_modulo() == modulo )
+          {
+               last = i;
+               return cached[ i ];
+          }
+     }
+     last = next;
+     next = ( next + 1 ) % reducer_slots;
+     cached[ last ] = ModReducer{ modulo };
+     return cached[ last ];
+}
+
+
+// sliding window exponentiation works with odd powers
+// base, base^3, ..., base^(2^window_bits - 1) in the internal form
+const size_t window_bits = 4;
+using WindowTable = std::array< uint64_t, 1 << ( window_bits - 1 ) >;
+
+
+WindowTable window_table( const ModReducer& red, uint64_t base )
+{
+     WindowTable table;
+     uint64_t square = red.mul_form( base, base );
+     table[ 0 ] = base;
+     for ( size_t i = 1; i < table.size(); i++ )
+     {
+          table[ i ] = red.mul_form( table[ i - 1 ], square );
+     }
+     return table;
+}
+
+
+// exponent split into odd windows, scanned from the top bit:
+// digits[ i ] is the window value ending at bit i, zero if none
+struct WindowPlan
+{
+     explicit WindowPlan( uint64_t exp );
+
+     std::array< uint8_t, 64 > digits{};
+     size_t bits = 0;
+};
+
+
+WindowPlan::WindowPlan( uint64_t exp )
+{
+     while ( bits < 64 && ( exp >> bits ) )
+     {
+          bits++;
+     }
+     size_t top = bits;
+     while ( top > 0 )
+     {
+          if ( !( ( exp >> ( top - 1 ) ) & 1 ) )
+          {
+               top--;
+               continue;
+          }
+          size_t low = ( top > window_bits ) ? top - window_bits : 0;
+          while ( !( ( exp >> low ) & 1 ) )
+          {
+               low++;
+          }
+          digits[ low ] = ( exp >> low ) & ( ( uint64_t{ 1 } << ( top - low ) ) - 1 );
+          top = low;
+     }
+}
+
+
+uint64_t pow_form( const ModReducer& red, const WindowTable& table, const WindowPlan& plan )
+{
+     uint64_t acc = red.one_form();
+     for ( size_t bit = plan.bits; bit-- > 0; )
+     {
+          acc = red.mul_form( acc, acc );
+          if ( plan.digits[ bit ] )
+          {
+               acc = red.mul_form( acc, table[ plan.digits[ bit ] >> 1 ] );
+          }
+     }
+     return acc;
+}
+
+
+uint64_t pow_form( const ModReducer& red, const WindowTable& table, uint64_t exp )
+{
+     return pow_form( red, table, WindowPlan{ exp } );
+}
+
+} // namespace
+
 
 Residue::Residue( uint64_t modulo, int64_t value ) noexcept:
      modulo_{ modulo }
@@ -17,7 +130,8 @@ Residue::Residue( uint64_t modulo, int64_t value ) noexcept:
      }
      else
      {
-          value_ = modulo_ - ( ( -value ) % modulo_ );
+          value_ = ( -static_cast< uint64_t >( value ) ) % modulo_;
+          value_ = value_ ? modulo_ - value_ : 0;
      }
 }
 
@@ -49,7 +163,7 @@ Residue& Residue::operator+= ( const Residue& other )
      {
           throw std::runtime_error{ "different modulo values" };
      }
-     value_ = ( value_ + other.value_ ) % modulo_;
+     value_ = reducer( modulo_ ).add( value_, other.value_ );
      return *this;
 }
 
@@ -69,7 +183,7 @@ Residue& Residue::operator-= ( const Residue& other )
      {
           throw std::runtime_error{ "different modulo values" };
      }
-     value_ = ( value_ + modulo_ - other.value_ ) % modulo_;
+     value_ = reducer( modulo_ ).sub( value_, other.value_ );
      return *this;
 }
 
@@ -85,7 +199,7 @@ Residue& Residue::operator*= ( const Residue& other )
      {
           throw std::runtime_error{ "different modulo values" };
      }
-     value_ = ( value_ * other.value_ ) % modulo_;
+     value_ = reducer( modulo_ ).mul( value_, other.value_ );
      return *this;
 }
 
@@ -100,7 +214,7 @@ Residue& Residue::operator/= ( const Residue& other )
      {
           throw std::runtime_error{ "different modulo values" };
      }
-     value_ = ( value_ * other.inv().value_ ) % modulo_;
+     value_ = reducer( modulo_ ).mul( value_, other.inv().value_ );
      return *this;
 }
 
@@ -182,28 +296,30 @@ Residue Residue::inv() const
           throw std::runtime_error{ "division by zero" };
      }
      // extended euclidean algorithm
-     uint64_t t    = 0, r    = modulo_;
-     uint64_t newt = 1, newr = value_;
+     // |t| <= modulo_, signed 128 bits keep the sign for any 64-bit modulo
+     __int128 t    = 0;
+     __int128 newt = 1;
+     uint64_t r = modulo_, newr = value_;
      while ( newr != 0 )
      {
           auto quotient = r / newr;
-          auto tmp = t - quotient * newt;
+          auto tmp = t - static_cast< __int128 >( quotient ) * newt;
           t    = newt;
           newt = tmp;
-          tmp  = r - quotient * newr;
+          auto rem = r - quotient * newr;
           r    = newr;
-          newr = tmp;
+          newr = rem;
      }
      if ( r > 1 )
      {
           throw std::runtime_error{ "not invertible element" };
      }
-     if ( t > modulo_ ) // unsigned t < 0
+     if ( t < 0 )
      {
           t += modulo_;
      }
      Residue ret( modulo_ );
-     ret.value_ = t % modulo_;
+     ret.value_ = static_cast< uint64_t >( t ) % modulo_;
      return ret;
 }
 
@@ -222,15 +338,7 @@ uint64_t Residue::get_value() const
 
 bool Residue::is_field() const
 {
-     uint64_t end = std::sqrt( modulo_ );
-     for ( uint64_t i = 2; i < end; i++ )
-     {
-          if ( modulo_ % i )
-          {
-               return false;
-          }
-     }
-     return true;
+     return is_prime( modulo_ );
 }
 
 Residue operator+ ( Residue a, const Residue& b ) { return a += b; }
@@ -245,10 +353,92 @@ Residue pow( const Residue& base, size_t exp )
      {
           return base;
      }
-     Residue result{ base.get_modulo(), 1 };
-     for ( size_t i = 0; i < exp; i++ )
+     const auto& red = reducer( base.modulo_ );
+     Residue result{ base.modulo_ };
+     result.value_ = red.from_form( pow_form( red, window_table( red, red.to_form( base.value_ ) ), exp ) );
+     return result;
+}
+
+
+std::vector< Residue > pow( const std::vector< Residue >& bases, size_t exp )
+{
+     std::vector< Residue > result;
+     result.reserve( bases.size() );
+     if ( bases.empty() )
+     {
+          return result;
+     }
+     WindowPlan plan{ exp };
+     for ( const auto& base : bases )
      {
-          result *= base;
+          if ( !base )
+          {
+               result.push_back( base );
+               continue;
+          }
+          const auto& red = reducer( base.modulo_ );
+          Residue power{ base.modulo_ };
+          power.value_ = red.from_form( pow_form( red, window_table( red, red.to_form( base.value_ ) ), plan ) );
+          result.push_back( power );
+     }
+     return result;
+}
+
+
+// interleaved sliding windows: all exponents share one chain of squarings
+Residue multi_pow( const std::vector< Residue >& bases, const std::vector< size_t >& exps )
+{
+     if ( bases.size() != exps.size() )
+     {
+          throw std::runtime_error{ "different numbers of bases and exponents" };
+     }
+     uint64_t modulo = 0;
+     for ( const auto& base : bases )
+     {
+          if ( base.modulo_ > 1 && modulo != 0 && base.modulo_ != modulo )
+          {
+               throw std::runtime_error{ "different modulo values" };
+          }
+          if ( base.modulo_ > 1 )
+          {
+               modulo = base.modulo_;
+          }
+     }
+     Residue result{ modulo };
+     if ( modulo == 0 )
+     {
+          return result;
+     }
+     const auto& red = reducer( modulo );
+     std::vector< WindowTable > tables;
+     std::vector< WindowPlan > plans;
+     size_t bits = 0;
+     for ( size_t i = 0; i < bases.size(); i++ )
+     {
+          if ( exps[ i ] == 0 )
+          {
+               continue;
+          }
+          if ( !bases[ i ] )
+          {
+               return result;     // zero factor
+          }
+          tables.push_back( window_table( red, red.to_form( bases[ i ].value_ ) ) );
+          plans.emplace_back( exps[ i ] );
+          bits = std::max( bits, plans.back().bits );
+     }
+     uint64_t acc = red.one_form();
+     for ( size_t bit = bits; bit-- > 0; )
+     {
+          acc = red.mul_form( acc, acc );
+          for ( size_t i = 0; i < plans.size(); i++ )
+          {
+               if ( plans[ i ].digits[ bit ] )
+               {
+                    acc = red.mul_form( acc, tables[ i ][ plans[ i ].digits[ bit ] >> 1 ] );
+               }
+          }
      }
-     return base;
+     result.value_ = red.from_form( acc );
+     return result;
 }
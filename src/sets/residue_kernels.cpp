@@ -0,0 +1,528 @@
+#include <sets/residue_kernels.h>
+
+#include <immintrin.h>
+
+namespace
+{
+
+// 32-bit Montgomery constants, R = 2^32
+struct Mont32
+{
+     uint32_t p;
+     uint32_t pinv;      // p^-1 mod 2^32
+     uint32_t r2;        // R^2 mod p
+};
+
+
+enum class Isa { scalar, avx2, avx512 };
+
+
+Isa detect_isa()
+{
+     __builtin_cpu_init();
+     if ( __builtin_cpu_supports( "avx512f" ) )
+     {
+          return Isa::avx512;
+     }
+     if ( __builtin_cpu_supports( "avx2" ) )
+     {
+          return Isa::avx2;
+     }
+     return Isa::scalar;
+}
+
+
+// vector code keeps sums below 2^32, so it needs p < 2^31,
+// and Montgomery reduction needs an odd p
+Isa isa_for( const ResidueRing& ring )
+{
+     static const Isa isa = detect_isa();
+     uint64_t p = ring.get_modulo();
+     if ( ( p & 1 ) && p < ( uint64_t{ 1 } << 31 ) )
+     {
+          return isa;
+     }
+     return Isa::scalar;
+}
+
+
+Mont32 mont32( uint64_t p )
+{
+     Mont32 m{ static_cast< uint32_t >( p ), static_cast< uint32_t >( p ), 0 };
+     for ( size_t i = 0; i < 4; i++ )
+     {
+          m.pinv *= 2 - m.p * m.pinv;
+     }
+     uint64_t r = ( uint64_t{ 1 } << 32 ) % p;
+     m.r2 = static_cast< uint32_t >( ( r * r ) % p );
+     return m;
+}
+
+
+// a * b * 2^-32 mod p
+inline uint32_t mont_mul( uint32_t a, uint32_t b, const Mont32& m )
+{
+     uint64_t t = static_cast< uint64_t >( a ) * b;
+     uint32_t q = static_cast< uint32_t >( t ) * m.pinv;
+     uint32_t t_hi = t >> 32;
+     uint32_t qp_hi = ( static_cast< uint64_t >( q ) * m.p ) >> 32;
+     return ( t_hi >= qp_hi ) ? t_hi - qp_hi : t_hi - qp_hi + m.p;
+}
+
+
+inline uint32_t add_mod( uint32_t a, uint32_t b, uint32_t p )
+{
+     uint32_t s = a + b;
+     return ( s >= p ) ? s - p : s;
+}
+
+//---------------------------------------------AVX2------------------------------------------------
+
+__attribute__(( target( "avx2" ) ))
+inline __m256i add_avx2( __m256i a, __m256i b, __m256i p )
+{
+     __m256i s = _mm256_add_epi32( a, b );
+     return _mm256_min_epu32( s, _mm256_sub_epi32( s, p ) );
+}
+
+
+__attribute__(( target( "avx2" ) ))
+inline __m256i sub_avx2( __m256i a, __m256i b, __m256i p )
+{
+     __m256i d = _mm256_sub_epi32( a, b );
+     return _mm256_min_epu32( d, _mm256_add_epi32( d, p ) );
+}
+
+
+// high halves of 32x32-bit products
+__attribute__(( target( "avx2" ) ))
+inline __m256i mulhi_avx2( __m256i a, __m256i b )
+{
+     __m256i even = _mm256_srli_epi64( _mm256_mul_epu32( a, b ), 32 );
+     __m256i odd  = _mm256_mul_epu32( _mm256_srli_epi64( a, 32 ), _mm256_srli_epi64( b, 32 ) );
+     return _mm256_blend_epi32( even, odd, 0xAA );
+}
+
+
+__attribute__(( target( "avx2" ) ))
+inline __m256i mont_avx2( __m256i a, __m256i b, __m256i p, __m256i pinv )
+{
+     __m256i q = _mm256_mullo_epi32( _mm256_mullo_epi32( a, b ), pinv );
+     __m256i r = _mm256_sub_epi32( mulhi_avx2( a, b ), mulhi_avx2( q, p ) );
+     return _mm256_min_epu32( r, _mm256_add_epi32( r, p ) );
+}
+
+
+__attribute__(( target( "avx2" ) ))
+void add_avx2( uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n, uint32_t p )
+{
+     __m256i vp = _mm256_set1_epi32( p );
+     size_t i = 0;
+     for ( ; i + 8 <= n; i += 8 )
+     {
+          __m256i va = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( a + i ) );
+          __m256i vb = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( b + i ) );
+          _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i ), add_avx2( va, vb, vp ) );
+     }
+     for ( ; i < n; i++ )
+     {
+          dst[ i ] = add_mod( a[ i ], b[ i ], p );
+     }
+}
+
+
+__attribute__(( target( "avx2" ) ))
+void sub_avx2( uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n, uint32_t p )
+{
+     __m256i vp = _mm256_set1_epi32( p );
+     size_t i = 0;
+     for ( ; i + 8 <= n; i += 8 )
+     {
+          __m256i va = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( a + i ) );
+          __m256i vb = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( b + i ) );
+          _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i ), sub_avx2( va, vb, vp ) );
+     }
+     for ( ; i < n; i++ )
+     {
+          dst[ i ] = add_mod( a[ i ], p - b[ i ], p );
+     }
+}
+
+
+__attribute__(( target( "avx2" ) ))
+void mul_avx2( uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n, const Mont32& m )
+{
+     __m256i vp = _mm256_set1_epi32( m.p ), vpinv = _mm256_set1_epi32( m.pinv );
+     __m256i vr2 = _mm256_set1_epi32( m.r2 );
+     size_t i = 0;
+     for ( ; i + 8 <= n; i += 8 )
+     {
+          __m256i va = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( a + i ) );
+          __m256i vb = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( b + i ) );
+          __m256i prod = mont_avx2( mont_avx2( va, vb, vp, vpinv ), vr2, vp, vpinv );
+          _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i ), prod );
+     }
+     for ( ; i < n; i++ )
+     {
+          dst[ i ] = mont_mul( mont_mul( a[ i ], b[ i ], m ), m.r2, m );
+     }
+}
+
+
+// c_form is c * 2^32 mod p, so one Montgomery step gives c * x
+__attribute__(( target( "avx2" ) ))
+void axpy_avx2( uint32_t* y, uint32_t c_form, const uint32_t* x, size_t n, const Mont32& m )
+{
+     __m256i vp = _mm256_set1_epi32( m.p ), vpinv = _mm256_set1_epi32( m.pinv );
+     __m256i vc = _mm256_set1_epi32( c_form );
+     size_t i = 0;
+     for ( ; i + 8 <= n; i += 8 )
+     {
+          __m256i vx = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( x + i ) );
+          __m256i vy = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( y + i ) );
+          vy = add_avx2( vy, mont_avx2( vx, vc, vp, vpinv ), vp );
+          _mm256_storeu_si256( reinterpret_cast< __m256i* >( y + i ), vy );
+     }
+     for ( ; i < n; i++ )
+     {
+          y[ i ] = add_mod( y[ i ], mont_mul( x[ i ], c_form, m ), m.p );
+     }
+}
+
+
+// returns sum of a[i] * b[i] * 2^-32 mod p
+__attribute__(( target( "avx2" ) ))
+uint32_t dot_avx2( const uint32_t* a, const uint32_t* b, size_t n, const Mont32& m )
+{
+     __m256i vp = _mm256_set1_epi32( m.p ), vpinv = _mm256_set1_epi32( m.pinv );
+     __m256i acc = _mm256_setzero_si256();
+     size_t i = 0;
+     for ( ; i + 8 <= n; i += 8 )
+     {
+          __m256i va = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( a + i ) );
+          __m256i vb = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( b + i ) );
+          acc = add_avx2( acc, mont_avx2( va, vb, vp, vpinv ), vp );
+     }
+     alignas( 32 ) uint32_t lanes[ 8 ];
+     _mm256_store_si256( reinterpret_cast< __m256i* >( lanes ), acc );
+     uint32_t sum = 0;
+     for ( auto lane : lanes )
+     {
+          sum = add_mod( sum, lane, m.p );
+     }
+     for ( ; i < n; i++ )
+     {
+          sum = add_mod( sum, mont_mul( a[ i ], b[ i ], m ), m.p );
+     }
+     return sum;
+}
+
+//--------------------------------------------AVX-512----------------------------------------------
+
+__attribute__(( target( "avx512f" ) ))
+inline __m512i add_avx512( __m512i a, __m512i b, __m512i p )
+{
+     __m512i s = _mm512_add_epi32( a, b );
+     return _mm512_min_epu32( s, _mm512_sub_epi32( s, p ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+inline __m512i sub_avx512( __m512i a, __m512i b, __m512i p )
+{
+     __m512i d = _mm512_sub_epi32( a, b );
+     return _mm512_min_epu32( d, _mm512_add_epi32( d, p ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+inline __m512i mulhi_avx512( __m512i a, __m512i b )
+{
+     __m512i even = _mm512_srli_epi64( _mm512_mul_epu32( a, b ), 32 );
+     __m512i odd  = _mm512_mul_epu32( _mm512_srli_epi64( a, 32 ), _mm512_srli_epi64( b, 32 ) );
+     return _mm512_mask_blend_epi32( 0xAAAA, even, odd );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+inline __m512i mont_avx512( __m512i a, __m512i b, __m512i p, __m512i pinv )
+{
+     __m512i q = _mm512_mullo_epi32( _mm512_mullo_epi32( a, b ), pinv );
+     __m512i r = _mm512_sub_epi32( mulhi_avx512( a, b ), mulhi_avx512( q, p ) );
+     return _mm512_min_epu32( r, _mm512_add_epi32( r, p ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+void add_avx512( uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n, uint32_t p )
+{
+     __m512i vp = _mm512_set1_epi32( p );
+     size_t i = 0;
+     for ( ; i + 16 <= n; i += 16 )
+     {
+          __m512i va = _mm512_loadu_si512( a + i );
+          __m512i vb = _mm512_loadu_si512( b + i );
+          _mm512_storeu_si512( dst + i, add_avx512( va, vb, vp ) );
+     }
+     for ( ; i < n; i++ )
+     {
+          dst[ i ] = add_mod( a[ i ], b[ i ], p );
+     }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+void sub_avx512( uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n, uint32_t p )
+{
+     __m512i vp = _mm512_set1_epi32( p );
+     size_t i = 0;
+     for ( ; i + 16 <= n; i += 16 )
+     {
+          __m512i va = _mm512_loadu_si512( a + i );
+          __m512i vb = _mm512_loadu_si512( b + i );
+          _mm512_storeu_si512( dst + i, sub_avx512( va, vb, vp ) );
+     }
+     for ( ; i < n; i++ )
+     {
+          dst[ i ] = add_mod( a[ i ], p - b[ i ], p );
+     }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+void mul_avx512( uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n, const Mont32& m )
+{
+     __m512i vp = _mm512_set1_epi32( m.p ), vpinv = _mm512_set1_epi32( m.pinv );
+     __m512i vr2 = _mm512_set1_epi32( m.r2 );
+     size_t i = 0;
+     for ( ; i + 16 <= n; i += 16 )
+     {
+          __m512i va = _mm512_loadu_si512( a + i );
+          __m512i vb = _mm512_loadu_si512( b + i );
+          _mm512_storeu_si512( dst + i, mont_avx512( mont_avx512( va, vb, vp, vpinv ), vr2, vp, vpinv ) );
+     }
+     for ( ; i < n; i++ )
+     {
+          dst[ i ] = mont_mul( mont_mul( a[ i ], b[ i ], m ), m.r2, m );
+     }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+void axpy_avx512( uint32_t* y, uint32_t c_form, const uint32_t* x, size_t n, const Mont32& m )
+{
+     __m512i vp = _mm512_set1_epi32( m.p ), vpinv = _mm512_set1_epi32( m.pinv );
+     __m512i vc = _mm512_set1_epi32( c_form );
+     size_t i = 0;
+     for ( ; i + 16 <= n; i += 16 )
+     {
+          __m512i vx = _mm512_loadu_si512( x + i );
+          __m512i vy = _mm512_loadu_si512( y + i );
+          _mm512_storeu_si512( y + i, add_avx512( vy, mont_avx512( vx, vc, vp, vpinv ), vp ) );
+     }
+     for ( ; i < n; i++ )
+     {
+          y[ i ] = add_mod( y[ i ], mont_mul( x[ i ], c_form, m ), m.p );
+     }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+uint32_t dot_avx512( const uint32_t* a, const uint32_t* b, size_t n, const Mont32& m )
+{
+     __m512i vp = _mm512_set1_epi32( m.p ), vpinv = _mm512_set1_epi32( m.pinv );
+     __m512i acc = _mm512_setzero_si512();
+     size_t i = 0;
+     for ( ; i + 16 <= n; i += 16 )
+     {
+          __m512i va = _mm512_loadu_si512( a + i );
+          __m512i vb = _mm512_loadu_si512( b + i );
+          acc = add_avx512( acc, mont_avx512( va, vb, vp, vpinv ), vp );
+     }
+     alignas( 64 ) uint32_t lanes[ 16 ];
+     _mm512_store_si512( lanes, acc );
+     uint32_t sum = 0;
+     for ( auto lane : lanes )
+     {
+          sum = add_mod( sum, lane, m.p );
+     }
+     for ( ; i < n; i++ )
+     {
+          sum = add_mod( sum, mont_mul( a[ i ], b[ i ], m ), m.p );
+     }
+     return sum;
+}
+
+//--------------------------------------------SCALAR-----------------------------------------------
+
+template < typename Word >
+void add_scalar( const ResidueRing& ring, Word* dst, const Word* a, const Word* b, size_t n )
+{
+     for ( size_t i = 0; i < n; i++ )
+     {
+          dst[ i ] = ring.add( a[ i ], b[ i ] );
+     }
+}
+
+
+template < typename Word >
+void sub_scalar( const ResidueRing& ring, Word* dst, const Word* a, const Word* b, size_t n )
+{
+     for ( size_t i = 0; i < n; i++ )
+     {
+          dst[ i ] = ring.sub( a[ i ], b[ i ] );
+     }
+}
+
+
+template < typename Word >
+void mul_scalar( const ResidueRing& ring, Word* dst, const Word* a, const Word* b, size_t n )
+{
+     const auto& reducer = ring.reducer();
+     for ( size_t i = 0; i < n; i++ )
+     {
+          dst[ i ] = reducer.mul( a[ i ], b[ i ] );
+     }
+}
+
+
+template < typename Word >
+void axpy_scalar( const ResidueRing& ring, Word* y, uint64_t c, const Word* x, size_t n )
+{
+     const auto& reducer = ring.reducer();
+     uint64_t c_form = reducer.to_form( c );
+     for ( size_t i = 0; i < n; i++ )
+     {
+          y[ i ] = reducer.add( y[ i ], reducer.mul_form( x[ i ], c_form ) );
+     }
+}
+
+
+template < typename Word >
+uint64_t dot_scalar( const ResidueRing& ring, const Word* a, const Word* b, size_t n )
+{
+     const auto& reducer = ring.reducer();
+     uint64_t sum = 0;
+     for ( size_t i = 0; i < n; i++ )
+     {
+          sum = reducer.add( sum, reducer.mul_form( a[ i ], b[ i ] ) );
+     }
+     // every product carries a factor R^-1 of the internal form,
+     // multiplying by R^2 in the internal form cancels it
+     return reducer.mul_form( sum, reducer.to_form( reducer.to_form( 1 ) ) );
+}
+
+} // namespace
+
+
+void residue_add( const ResidueRing& ring, uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n )
+{
+     switch ( isa_for( ring ) )
+     {
+     case Isa::avx512:
+          add_avx512( dst, a, b, n, ring.get_modulo() );
+          break;
+     case Isa::avx2:
+          add_avx2( dst, a, b, n, ring.get_modulo() );
+          break;
+     default:
+          add_scalar( ring, dst, a, b, n );
+     }
+}
+
+
+void residue_add( const ResidueRing& ring, uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n )
+{
+     add_scalar( ring, dst, a, b, n );
+}
+
+
+void residue_sub( const ResidueRing& ring, uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n )
+{
+     switch ( isa_for( ring ) )
+     {
+     case Isa::avx512:
+          sub_avx512( dst, a, b, n, ring.get_modulo() );
+          break;
+     case Isa::avx2:
+          sub_avx2( dst, a, b, n, ring.get_modulo() );
+          break;
+     default:
+          sub_scalar( ring, dst, a, b, n );
+     }
+}
+
+
+void residue_sub( const ResidueRing& ring, uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n )
+{
+     sub_scalar( ring, dst, a, b, n );
+}
+
+
+void residue_mul( const ResidueRing& ring, uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n )
+{
+     switch ( isa_for( ring ) )
+     {
+     case Isa::avx512:
+          mul_avx512( dst, a, b, n, mont32( ring.get_modulo() ) );
+          break;
+     case Isa::avx2:
+          mul_avx2( dst, a, b, n, mont32( ring.get_modulo() ) );
+          break;
+     default:
+          mul_scalar( ring, dst, a, b, n );
+     }
+}
+
+
+void residue_mul( const ResidueRing& ring, uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n )
+{
+     mul_scalar( ring, dst, a, b, n );
+}
+
+
+void residue_axpy( const ResidueRing& ring, uint32_t* y, uint64_t c, const uint32_t* x, size_t n )
+{
+     auto isa = isa_for( ring );
+     if ( isa == Isa::scalar )
+     {
+          axpy_scalar( ring, y, c, x, n );
+          return;
+     }
+     auto m = mont32( ring.get_modulo() );
+     uint32_t c_form = mont_mul( static_cast< uint32_t >( c ), m.r2, m );
+     if ( isa == Isa::avx512 )
+     {
+          axpy_avx512( y, c_form, x, n, m );
+     }
+     else
+     {
+          axpy_avx2( y, c_form, x, n, m );
+     }
+}
+
+
+void residue_axpy( const ResidueRing& ring, uint64_t* y, uint64_t c, const uint64_t* x, size_t n )
+{
+     axpy_scalar( ring, y, c, x, n );
+}
+
+
+uint64_t residue_dot( const ResidueRing& ring, const uint32_t* a, const uint32_t* b, size_t n )
+{
+     auto isa = isa_for( ring );
+     if ( isa == Isa::scalar )
+     {
+          return dot_scalar( ring, a, b, n );
+     }
+     auto m = mont32( ring.get_modulo() );
+     uint32_t sum = ( isa == Isa::avx512 ) ? dot_avx512( a, b, n, m ) : dot_avx2( a, b, n, m );
+     // sum * R^2 * R^-1 == sum * R cancels the factor R^-1 of each product
+     return mont_mul( sum, m.r2, m );
+}
+
+
+uint64_t residue_dot( const ResidueRing& ring, const uint64_t* a, const uint64_t* b, size_t n )
+{
+     return dot_scalar( ring, a, b, n );
+}
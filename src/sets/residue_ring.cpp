@@ -0,0 +1,90 @@
+#include <sets/residue_ring.h>
+
+#include <stdexcept>
+
+ResidueRing::ResidueRing( uint64_t modulo ):
+     reducer_{ modulo }
+{
+     if ( modulo <= 1 )
+     {
+          throw std::runtime_error{ "modulo must be greater than 1" };
+     }
+}
+
+
+bool ResidueRing::operator== ( const ResidueRing& other ) const
+{
+     return get_modulo() == other.get_modulo();
+}
+
+
+bool ResidueRing::operator!= ( const ResidueRing& other ) const
+{
+     return !( *this == other );
+}
+
+
+uint64_t ResidueRing::reduce( int64_t value ) const
+{
+     return Residue{ get_modulo(), value }.get_value();
+}
+
+
+uint64_t ResidueRing::add( uint64_t a, uint64_t b ) const
+{
+     return reducer_.add( a, b );
+}
+
+
+uint64_t ResidueRing::sub( uint64_t a, uint64_t b ) const
+{
+     return reducer_.sub( a, b );
+}
+
+
+uint64_t ResidueRing::neg( uint64_t a ) const
+{
+     return reducer_.neg( a );
+}
+
+
+uint64_t ResidueRing::mul( uint64_t a, uint64_t b ) const
+{
+     return reducer_.mul( a, b );
+}
+
+
+uint64_t ResidueRing::inv( uint64_t a ) const
+{
+     return element( a ).inv().get_value();
+}
+
+
+Residue ResidueRing::element( uint64_t value ) const
+{
+     Residue ret{ get_modulo() };
+     ret.value_ = value % get_modulo();
+     return ret;
+}
+
+
+uint64_t ResidueRing::value_of( const Residue& elem ) const
+{
+     if ( elem && elem.get_modulo() != get_modulo() )
+     {
+          throw std::runtime_error{ "different modulo values" };
+     }
+     return elem.get_value();
+}
+
+
+uint64_t ResidueRing::get_modulo() const
+{
+     return reducer_.get_modulo();
+}
+
+
+const ModReducer& ResidueRing::reducer() const
+{
+     return reducer_;
+}